@@ -20,12 +20,15 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/geometric.hpp>
 
 #include "UmfeldConstants.h"
+#include "WorkerPool.h"
 
 // #define GEOMETRY_DRAW_DEBUG
 
@@ -71,6 +74,102 @@ namespace umfeld {
         // TODO one day replace by Weighted Blended Order-Independent Transparency (WBOIT)
     }
 
+    /**
+     * stable LSD radix sort of `keys` ( ascending, 8 bits per pass ) that applies the same permutation
+     * to `values`. passes in which all keys share the same digit are skipped. large inputs are
+     * histogrammed and scattered on the threads of `shared_worker_pool()`, each task handling a
+     * contiguous chunk.
+     *
+     * @param keys
+     * @param values
+     * @param scratch_keys reused between calls to avoid allocations
+     * @param scratch_values reused between calls to avoid allocations
+     * @param num_key_bits number of significant bits in keys ( rounded up to multiple of 8 )
+     * @param max_threads 0 to use all threads of the shared worker pool
+     */
+    inline void radix_sort(std::vector<uint32_t>& keys,
+                           std::vector<uint32_t>& values,
+                           std::vector<uint32_t>& scratch_keys,
+                           std::vector<uint32_t>& scratch_values,
+                           const int              num_key_bits = 32,
+                           unsigned               max_threads  = 0) {
+        constexpr int    RADIX_BITS              = 8;
+        constexpr int    RADIX_SIZE              = 1 << RADIX_BITS;
+        constexpr size_t MIN_ELEMENTS_PER_THREAD = 1 << 15;
+        const size_t     num_elements            = keys.size();
+        const int        num_passes              = (std::min(num_key_bits, 32) + RADIX_BITS - 1) / RADIX_BITS;
+        if (num_elements < 2 || values.size() != num_elements) {
+            return;
+        }
+        scratch_keys.resize(num_elements);
+        scratch_values.resize(num_elements);
+
+        size_t num_threads = 1;
+        if (num_elements >= 2 * MIN_ELEMENTS_PER_THREAD) {
+            // NOTE the shared pool is only touched ( and created ) for inputs large enough to be split
+            const size_t pool_threads = shared_worker_pool().num_threads();
+            const size_t limit        = max_threads == 0 ? pool_threads : std::min<size_t>(max_threads, pool_threads);
+            num_threads               = std::clamp<size_t>(num_elements / MIN_ELEMENTS_PER_THREAD, 1, limit);
+        }
+
+        std::vector<std::array<size_t, RADIX_SIZE>> histograms(num_threads);
+        const auto                                  run_chunks = [&](const auto& task) {
+            if (num_threads == 1) {
+                task(0, 0, num_elements);
+                return;
+            }
+            shared_worker_pool().parallel_for(num_threads, [&](const size_t t) {
+                task(t, num_elements * t / num_threads, num_elements * (t + 1) / num_threads);
+            });
+        };
+
+        for (int pass = 0; pass < num_passes; ++pass) {
+            const int shift = pass * RADIX_BITS;
+
+            run_chunks([&](const size_t t, const size_t begin, const size_t end) {
+                auto& histogram = histograms[t];
+                histogram.fill(0);
+                for (size_t i = begin; i < end; ++i) {
+                    histogram[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                }
+            });
+
+            // NOTE skip pass if all keys share the same digit
+            bool skip_pass = false;
+            for (int digit = 0; digit < RADIX_SIZE && !skip_pass; ++digit) {
+                size_t count = 0;
+                for (size_t t = 0; t < num_threads; ++t) {
+                    count += histograms[t][digit];
+                }
+                skip_pass = count == num_elements;
+            }
+            if (skip_pass) {
+                continue;
+            }
+
+            // NOTE convert counts to scatter offsets ( digit-major, then thread ) to keep the sort stable
+            size_t offset = 0;
+            for (int digit = 0; digit < RADIX_SIZE; ++digit) {
+                for (size_t t = 0; t < num_threads; ++t) {
+                    const size_t count   = histograms[t][digit];
+                    histograms[t][digit] = offset;
+                    offset += count;
+                }
+            }
+
+            run_chunks([&](const size_t t, const size_t begin, const size_t end) {
+                auto& histogram = histograms[t];
+                for (size_t i = begin; i < end; ++i) {
+                    const size_t destination    = histogram[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                    scratch_keys[destination]   = keys[i];
+                    scratch_values[destination] = values[i];
+                }
+            });
+            keys.swap(scratch_keys);
+            values.swap(scratch_values);
+        }
+    }
+
     inline void triangulate_polygon(const std::vector<glm::vec2>& polygon_outline,
                                     std::vector<glm::vec2>&       resulting_triangles) {
         TESStesselator* tess = tessNewTess(nullptr);
@@ -563,14 +662,19 @@ namespace umfeld {
         return fan;
     }
 
-    inline std::vector<Vertex> convertTriangleStripToTriangles(const std::vector<Vertex>& strip) {
+    /**
+     * converts triangle strip to triangles. `triangles` is cleared first, its capacity is retained.
+     * @param strip
+     * @param triangles
+     */
+    inline void convertTriangleStripToTriangles(const std::vector<Vertex>& strip, std::vector<Vertex>& triangles) {
+        triangles.clear();
         if (strip.size() < 3) {
-            return {}; // Not enough vertices for a triangle
+            return; // Not enough vertices for a triangle
         }
 
-        const size_t        numTriangles = strip.size() - 2; // Number of triangles in the strip
-        std::vector<Vertex> triangles;
-        triangles.reserve(numTriangles * 3); // Pre-allocate memory
+        const size_t numTriangles = strip.size() - 2; // Number of triangles in the strip
+        triangles.reserve(numTriangles * 3);          // Pre-allocate memory
 
         for (size_t i = 0; i < numTriangles; ++i) {
             if (i % 2 == 0) {
@@ -585,18 +689,27 @@ namespace umfeld {
                 triangles.emplace_back(strip[i + 2]);
             }
         }
+    }
 
+    inline std::vector<Vertex> convertTriangleStripToTriangles(const std::vector<Vertex>& strip) {
+        std::vector<Vertex> triangles;
+        convertTriangleStripToTriangles(strip, triangles);
         return triangles;
     }
 
-    inline std::vector<Vertex> convertTriangleFanToTriangles(const std::vector<Vertex>& fan) {
+    /**
+     * converts triangle fan to triangles. `triangles` is cleared first, its capacity is retained.
+     * @param fan
+     * @param triangles
+     */
+    inline void convertTriangleFanToTriangles(const std::vector<Vertex>& fan, std::vector<Vertex>& triangles) {
+        triangles.clear();
         if (fan.size() < 3) {
-            return {}; // Not enough vertices for a triangle
+            return; // Not enough vertices for a triangle
         }
 
-        const size_t        numTriangles = fan.size() - 2; // Number of triangles in the fan
-        std::vector<Vertex> triangles;
-        triangles.reserve(numTriangles * 3); // Pre-allocate memory
+        const size_t numTriangles = fan.size() - 2; // Number of triangles in the fan
+        triangles.reserve(numTriangles * 3);        // Pre-allocate memory
 
         const Vertex& anchor = fan[0]; // The first vertex is the anchor
 
@@ -609,17 +722,27 @@ namespace umfeld {
             triangles.emplace_back(fan[i]);
             triangles.emplace_back(fan[i + 1]);
         }
+    }
+
+    inline std::vector<Vertex> convertTriangleFanToTriangles(const std::vector<Vertex>& fan) {
+        std::vector<Vertex> triangles;
+        convertTriangleFanToTriangles(fan, triangles);
         return triangles;
     }
 
-    inline std::vector<Vertex> convertQuadStripToQuads(const std::vector<Vertex>& quadStrip) {
+    /**
+     * converts quad strip to quads. `quads` is cleared first, its capacity is retained.
+     * @param quadStrip
+     * @param quads
+     */
+    inline void convertQuadStripToQuads(const std::vector<Vertex>& quadStrip, std::vector<Vertex>& quads) {
+        quads.clear();
         if (quadStrip.size() < 4) {
-            return {}; // Not enough vertices to form at least one quad
+            return; // Not enough vertices to form at least one quad
         }
 
-        size_t              numQuads = (quadStrip.size() - 2) / 2; // Each quad requires 2 new vertices
-        std::vector<Vertex> quads;
-        quads.reserve(numQuads * 4); // Each quad has 4 vertices
+        const size_t numQuads = (quadStrip.size() - 2) / 2; // Each quad requires 2 new vertices
+        quads.reserve(numQuads * 4);                        // Each quad has 4 vertices
 
         for (size_t i = 0; i < quadStrip.size() - 2; i += 2) {
             // Each quad consists of:
@@ -633,17 +756,27 @@ namespace umfeld {
             quads.emplace_back(quadStrip[i + 3]); // Top-right
             quads.emplace_back(quadStrip[i + 2]); // Top-left
         }
+    }
 
+    inline std::vector<Vertex> convertQuadStripToQuads(const std::vector<Vertex>& quadStrip) {
+        std::vector<Vertex> quads;
+        convertQuadStripToQuads(quadStrip, quads);
         return quads;
     }
 
-    inline std::vector<Vertex> convertQuadsToTriangles(const std::vector<Vertex>& quads) {
+    /**
+     * converts quads to triangles. `triangles` is cleared first, its capacity is retained.
+     * @param quads
+     * @param triangles
+     */
+    inline void convertQuadsToTriangles(const std::vector<Vertex>& quads, std::vector<Vertex>& triangles) {
+        triangles.clear();
         if (quads.size() < 4) {
-            return {};
+            return;
         }
 
-        std::vector<Vertex> triangles;
-        const size_t        validQuadCount = quads.size() / 4; // only use full quads
+        const size_t validQuadCount = quads.size() / 4; // only use full quads
+        triangles.reserve(validQuadCount * 6);
 
         for (size_t i = 0; i < validQuadCount * 4; i += 4) {
             // First triangle (0-1-2)
@@ -656,15 +789,26 @@ namespace umfeld {
             triangles.push_back(quads[i + 3]);
             triangles.push_back(quads[i + 0]);
         }
+    }
+
+    inline std::vector<Vertex> convertQuadsToTriangles(const std::vector<Vertex>& quads) {
+        std::vector<Vertex> triangles;
+        convertQuadsToTriangles(quads, triangles);
         return triangles;
     }
 
-    inline std::vector<Vertex> convertPointsToTriangles(const std::vector<Vertex>& points, float size) {
+    /**
+     * converts points to quads made of two triangles. `triangles` is cleared first, its capacity is retained.
+     * @param points
+     * @param size
+     * @param triangles
+     */
+    inline void convertPointsToTriangles(const std::vector<Vertex>& points, const float size, std::vector<Vertex>& triangles) {
+        triangles.clear();
         if (points.empty()) {
-            return {};
+            return;
         }
 
-        std::vector<Vertex> triangles;
         triangles.reserve(points.size() * 6); // Each point → 2 triangles → 6 vertices
 
         float halfSize = size * 0.5f;
@@ -691,7 +835,11 @@ namespace umfeld {
             triangles.emplace_back(v3);
             triangles.emplace_back(v0);
         }
+    }
 
+    inline std::vector<Vertex> convertPointsToTriangles(const std::vector<Vertex>& points, const float size) {
+        std::vector<Vertex> triangles;
+        convertPointsToTriangles(points, size, triangles);
         return triangles;
     }
 
@@ -0,0 +1,191 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stb_image_write.h"
+#include "UmfeldConstants.h"
+#include "UmfeldFunctionsAdditional.h"
+
+namespace umfeld {
+    /**
+     * writes RGBA images to PNG, JPG, BMP or TGA files on background threads. the queue is bounded:
+     * if it is full `encode` blocks until a worker takes the next job ( back-pressure ). this way a
+     * sketch recording frames slows down to the speed of the encoder instead of running out of memory.
+     * jobs writing the same file are never written concurrently and are written in the order they
+     * were queued, so the last image queued for a file wins.
+     */
+    class ImageEncoder {
+    public:
+        explicit ImageEncoder(const unsigned num_threads = 2, const size_t max_queued_jobs = 8)
+            : max_queued_jobs(std::max<size_t>(max_queued_jobs, 1)) {
+            const unsigned num_workers = std::max(1u, num_threads);
+            workers.reserve(num_workers);
+            for (unsigned i = 0; i < num_workers; ++i) {
+                workers.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        /**
+         * writes all queued jobs before returning
+         */
+        ~ImageEncoder() {
+            {
+                std::lock_guard lock(mutex);
+                running = false;
+            }
+            job_available.notify_all();
+            for (auto& worker: workers) {
+                worker.join();
+            }
+        }
+
+        ImageEncoder(const ImageEncoder&)            = delete;
+        ImageEncoder& operator=(const ImageEncoder&) = delete;
+
+        static bool is_supported(const std::string& filename) {
+            return ends_with(filename, ".png") ||
+                   ends_with(filename, ".jpg") ||
+                   ends_with(filename, ".bmp") ||
+                   ends_with(filename, ".tga");
+        }
+
+        /**
+         * queues `pixels` ( RGBA, tightly packed ) to be written to `filename`. blocks while the queue
+         * is full.
+         * @param flip_vertically if true rows are written bottom-up e.g for pixels read from OpenGL
+         */
+        void encode(const std::string& filename, const int width, const int height, std::vector<unsigned char>&& pixels, const bool flip_vertically) {
+            {
+                std::unique_lock lock(mutex);
+                job_taken.wait(lock, [this] { return jobs.size() < max_queued_jobs; });
+                jobs.push_back({filename, width, height, std::move(pixels), flip_vertically});
+            }
+            job_available.notify_one();
+        }
+
+        /**
+         * blocks until all queued jobs are written
+         */
+        void wait() {
+            std::unique_lock lock(mutex);
+            job_done.wait(lock, [this] { return jobs.empty() && files_in_progress.empty(); });
+        }
+
+    private:
+        struct Job {
+            std::string                filename;
+            int                        width;
+            int                        height;
+            std::vector<unsigned char> pixels;
+            bool                       flip_vertically;
+        };
+
+        std::vector<std::thread> workers;
+        std::deque<Job>          jobs;
+        std::vector<std::string> files_in_progress; // NOTE one entry per job currently written by a worker
+        std::mutex               mutex;
+        std::condition_variable  job_available;
+        std::condition_variable  job_taken;
+        std::condition_variable  job_done;
+        const size_t             max_queued_jobs;
+        bool                     running{true};
+
+        /**
+         * @return index of the first job whose file is neither written by a worker nor by an earlier
+         *         queued job or `jobs.size()` if there is none
+         */
+        size_t next_job_index() const {
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                const std::string& filename = jobs[i].filename;
+                const bool         blocked  = std::find(files_in_progress.begin(), files_in_progress.end(), filename) != files_in_progress.end() ||
+                                     std::any_of(jobs.begin(), jobs.begin() + static_cast<std::ptrdiff_t>(i), [&filename](const Job& earlier) { return earlier.filename == filename; });
+                if (!blocked) {
+                    return i;
+                }
+            }
+            return jobs.size();
+        }
+
+        void worker_loop() {
+            while (true) {
+                Job job;
+                {
+                    std::unique_lock lock(mutex);
+                    size_t           index = 0;
+                    job_available.wait(lock, [this, &index] {
+                        index = next_job_index();
+                        return index < jobs.size() || (!running && jobs.empty());
+                    });
+                    if (index == jobs.size()) {
+                        return; // NOTE only stops once all jobs are written
+                    }
+                    job = std::move(jobs[index]);
+                    jobs.erase(jobs.begin() + static_cast<std::ptrdiff_t>(index));
+                    files_in_progress.push_back(job.filename);
+                }
+                job_taken.notify_one();
+                write(job);
+                {
+                    std::lock_guard lock(mutex);
+                    files_in_progress.erase(std::find(files_in_progress.begin(), files_in_progress.end(), job.filename));
+                }
+                job_done.notify_all();
+                job_available.notify_all(); // NOTE a job for the same file might be waiting
+            }
+        }
+
+        static void write(Job& job) {
+            const int row_size = job.width * DEFAULT_BYTES_PER_PIXELS;
+            if (job.pixels.size() < static_cast<size_t>(row_size) * job.height) {
+                warning("image data too small. not saving image: ", job.filename);
+                return;
+            }
+            if (job.flip_vertically) {
+                for (int y = 0; y < job.height / 2; ++y) {
+                    std::swap_ranges(job.pixels.begin() + y * row_size,
+                                     job.pixels.begin() + (y + 1) * row_size,
+                                     job.pixels.begin() + (job.height - 1 - y) * row_size);
+                }
+            }
+            const char* filename = job.filename.c_str();
+            int         success  = 0;
+            if (ends_with(job.filename, ".png")) {
+                success = stbi_write_png(filename, job.width, job.height, DEFAULT_BYTES_PER_PIXELS, job.pixels.data(), row_size);
+            } else if (ends_with(job.filename, ".jpg")) {
+                success = stbi_write_jpg(filename, job.width, job.height, DEFAULT_BYTES_PER_PIXELS, job.pixels.data(), 100);
+            } else if (ends_with(job.filename, ".bmp")) {
+                success = stbi_write_bmp(filename, job.width, job.height, DEFAULT_BYTES_PER_PIXELS, job.pixels.data());
+            } else if (ends_with(job.filename, ".tga")) {
+                success = stbi_write_tga(filename, job.width, job.height, DEFAULT_BYTES_PER_PIXELS, job.pixels.data());
+            }
+            if (!success) {
+                warning("could not write image: ", job.filename);
+            }
+        }
+    };
+} // namespace umfeld
@@ -0,0 +1,171 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SPSCQueue.h"
+
+#ifndef DISABLE_GRAPHICS
+#ifndef DISABLE_VIDEO
+extern "C" {
+#include "libavformat/avformat.h"
+#include "libavcodec/avcodec.h"
+#include "libswscale/swscale.h"
+}
+#endif // DISABLE_VIDEO
+#endif // DISABLE_GRAPHICS
+
+namespace umfeld {
+
+    class PGraphics;
+    extern PGraphics* g;
+
+    /**
+     * encodes frames ( and optionally audio ) into a movie file on a dedicated thread. frames are
+     * usually taken from the framebuffer with `add_frame(graphics)`, which uses the asynchronous
+     * readback of the renderer. the container is derived from the file extension e.g:
+     *
+     * - `H264` :: `.mp4` or `.mov` ( audio is encoded as AAC )
+     * - `PRORES` :: `.mov` ( audio is stored as 16-bit PCM )
+     * - `FFV1` :: `.mkv` ( lossless, audio is stored as 16-bit PCM )
+     *
+     * the frame queue is bounded: if the encoder falls behind `add_frame` blocks until a frame was
+     * encoded. audio is passed to the encoder through a wait-free queue, so it can be added from the
+     * audio thread e.g in `audioEvent()` with `add_audio(audio_output_buffer, audio_buffer_size)`.
+     */
+    class MovieRecorder {
+    public:
+        enum Codec {
+            H264 = 0,
+            PRORES,
+            FFV1,
+        };
+
+        /**
+         * @param audio_channels number of interleaved audio channels or `0` to record video only
+         */
+        MovieRecorder(const std::string& filename,
+                      int                width,
+                      int                height,
+                      float              frame_rate,
+                      Codec              codec             = H264,
+                      int                audio_channels    = 0,
+                      int                audio_sample_rate = 0,
+                      size_t             max_queued_frames = 8);
+        ~MovieRecorder();
+
+        MovieRecorder(const MovieRecorder&)            = delete;
+        MovieRecorder& operator=(const MovieRecorder&) = delete;
+
+        bool start();
+        /**
+         * reads the framebuffer of `graphics` asynchronously and queues it as the next frame
+         */
+        bool add_frame(PGraphics* graphics = g);
+        /**
+         * queues RGBA pixels ( tightly packed, `width` × `height` ) as the next frame. blocks while the
+         * queue is full.
+         * @param flip_vertically true for pixels read from OpenGL ( rows bottom-up )
+         */
+        bool add_frame(std::vector<unsigned char>&& pixels, bool flip_vertically);
+        /**
+         * queues interleaved audio samples. never blocks, locks or allocates. samples are dropped if the
+         * encoder falls behind by more than `AUDIO_QUEUE_CAPACITY` samples. must always be called from
+         * the same thread.
+         */
+        void add_audio(const float* samples, int num_frames);
+        /**
+         * encodes all queued frames and audio, closes the file and stops the encoder thread
+         */
+        void finish();
+        bool is_recording() const { return recording; }
+        int  frame_count() const { return num_frames_added; }
+
+    private:
+        static constexpr size_t AUDIO_QUEUE_CAPACITY = 1 << 20; // NOTE samples i.e ~10sec of stereo audio at 48kHz
+        static constexpr int    AUDIO_DRAIN_INTERVAL = 10;      // NOTE milliseconds
+
+        struct VideoFrame {
+            std::vector<unsigned char> pixels;
+            int                        width;
+            int                        height;
+            bool                       flip_vertically;
+        };
+
+        const std::string filename;
+        const int         width;
+        const int         height;
+        const float       frame_rate;
+        const Codec       codec;
+        const int         audio_channels;
+        const int         audio_sample_rate;
+        const size_t      max_queued_frames;
+
+        std::thread             encoder_thread;
+        std::mutex              mutex;
+        std::condition_variable work_available;
+        std::condition_variable frame_taken;
+        std::deque<VideoFrame>  video_frames;
+        PGraphics*              readback_graphics{nullptr}; // NOTE graphics with readbacks that might still add frames
+        std::atomic<bool>       recording{false};
+        std::atomic<int>        num_audio_frames_dropped{0};
+        bool                    stopping{false};
+        int                     num_frames_added{0};
+
+#ifndef DISABLE_GRAPHICS
+#ifndef DISABLE_VIDEO
+        AVFormatContext*   format_context{nullptr};
+        AVCodecContext*    video_codec_context{nullptr};
+        AVCodecContext*    audio_codec_context{nullptr};
+        AVStream*          video_stream{nullptr};
+        AVStream*          audio_stream{nullptr};
+        AVFrame*           video_frame{nullptr};
+        AVFrame*           audio_frame{nullptr};
+        AVPacket*          packet{nullptr};
+        SwsContext*        sws_context{nullptr};
+        int64_t            video_pts{0};
+        int64_t            audio_pts{0};
+        std::vector<float> audio_pending; // NOTE interleaved samples not yet filling a complete audio frame
+
+        std::unique_ptr<SPSCQueue<float, AUDIO_QUEUE_CAPACITY>> audio_queue; // NOTE interleaved, filled by `add_audio`
+
+        bool open_video_stream();
+        bool open_audio_stream();
+        void encode_video(const VideoFrame& frame);
+        void drain_audio();
+        void encode_audio(bool flush);
+        bool write_packets(AVCodecContext* codec_context, const AVStream* stream);
+#endif // DISABLE_VIDEO
+#endif // DISABLE_GRAPHICS
+
+        bool queue_frame(std::vector<unsigned char>&& pixels, int frame_width, int frame_height, bool flip_vertically);
+        bool open();
+        void close();
+        void encoder_loop();
+    };
+} // namespace umfeld
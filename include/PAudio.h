@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 
 namespace umfeld {
@@ -63,5 +64,15 @@ namespace umfeld {
     public:
         explicit PAudio(const AudioUnitInfo* device_info);
         void copy_input_buffer_to_output_buffer() const;
+        /**
+         * number of buffer underruns or overruns ( xruns ) since the device was created. an xrun is
+         * counted if the driver reports one or if processing a buffer took longer than playing it.
+         * may be queried from any thread.
+         */
+        int  xruns() const { return xrun_count.load(std::memory_order_relaxed); }
+        void report_xrun() { xrun_count.fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int> xrun_count{0};
     };
 } // namespace umfeld
\ No newline at end of file
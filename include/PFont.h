@@ -26,6 +26,8 @@
 #include <codecvt>
 
 #include <algorithm>
+#include <limits>
+#include <list>
 #include <vector>
 #include <unordered_map>
 
@@ -38,9 +40,15 @@
 #include "ft2build.h"
 #include FT_FREETYPE_H
 #include FT_OUTLINE_H
+#include FT_MODULE_H
+
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define PFONT_SUPPORTS_SDF // NOTE FreeType ships an SDF renderer since 2.11
+#endif
 
 #include "UmfeldFunctionsAdditional.h"
 #include "PImage.h"
+#include "SkylinePacker.h"
 
 namespace umfeld {
     struct TexturedQuad {
@@ -48,24 +56,33 @@ namespace umfeld {
         float x1, y1, u1, v1; // Top-right
         float x2, y2, u2, v2; // Bottom-right
         float x3, y3, u3, v3; // Bottom-left
+        int   page;           // atlas page
 
         TexturedQuad(const float _x0, const float _y0, const float _u0, const float _v0,
                      const float _x1, const float _y1, const float _u1, const float _v1,
                      const float _x2, const float _y2, const float _u2, const float _v2,
-                     const float _x3, const float _y3, const float _u3, const float _v3)
+                     const float _x3, const float _y3, const float _u3, const float _v3,
+                     const int   _page = 0)
             : x0(_x0), y0(_y0), u0(_u0), v0(_v0),
               x1(_x1), y1(_y1), u1(_u1), v1(_v1),
               x2(_x2), y2(_y2), u2(_u2), v2(_v2),
-              x3(_x3), y3(_y3), u3(_u3), v3(_v3) {}
+              x3(_x3), y3(_y3), u3(_u3), v3(_v3),
+              page(_page) {}
     };
 
     class PFont final : public PImage {
         const std::string character_atlas_default = " ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789!@#$%^&*()[]{}-_=+;:'\",<.>/?`~";
 
     public:
+        /**
+         * @param signed_distance_field if true glyphs are stored as signed distance fields rasterized at
+         *                              `sdf_font_size` ( at least ). one atlas then serves all text sizes
+         *                              but requires a renderer with SDF support ( see `is_signed_distance_field()` )
+         */
         explicit PFont(const std::string& font_filepath,
                        const int          font_size,
-                       const float        pixelDensity = 1) : font_size(font_size) {
+                       const float        pixelDensity          = 1,
+                       const bool         signed_distance_field = false) : font_size(signed_distance_field ? std::max(font_size, sdf_font_size) : font_size) {
             const std::string character_atlas = character_atlas_default;
             (void) pixelDensity; // TODO implement pixel density
 
@@ -75,24 +92,40 @@ namespace umfeld {
             font         = new FontData();
             font->buffer = hb_buffer_create();
             FT_New_Face(freetype, filepath_c, 0, &font->face);
-            FT_Set_Pixel_Sizes(font->face, 0, font_size);
+            FT_Set_Pixel_Sizes(font->face, 0, static_cast<FT_UInt>(this->font_size));
             font->hb_font = hb_ft_font_create(font->face, nullptr);
 
-            create_font_atlas(*font, character_atlas);
+            if (signed_distance_field) {
+#ifdef PFONT_SUPPORTS_SDF
+                constexpr FT_Int spread = sdf_spread;
+                FT_Property_Set(freetype, "sdf", "spread", &spread);
+                font->signed_distance_field = true;
+#else
+                warning("PFont: signed distance fields require FreeType 2.11 or newer … using regular glyphs");
+#endif // PFONT_SUPPORTS_SDF
+            }
 
             // TODO see if pixel density needs to or should be respected in the atlas
 
+            /* the font image itself is the first atlas page, more pages are added once it is full */
+            font->page_size = font->signed_distance_field ? atlas_pixel_width * 2 : atlas_pixel_width;
+            while (font->page_size < this->font_size * 4 && font->page_size < atlas_max_page_size) {
+                font->page_size *= 2;
+            }
             // texture_id = create_font_texture(*font); // NOTE this is done in PGraphics
-            width  = static_cast<float>(font->atlas_width);
-            height = static_cast<float>(font->atlas_height);
+            width  = static_cast<float>(font->page_size);
+            height = static_cast<float>(font->page_size);
             format = 4;
-            pixels = new uint32_t[static_cast<int>(width * height)];
-            copy_atlas_to_rgba(*font, reinterpret_cast<unsigned char*>(pixels));
+            pixels = new uint32_t[font->page_size * font->page_size];
+            clear_page_pixels(pixels, font->page_size);
+            font->pages.push_back({this, false, SkylinePacker(font->page_size, font->page_size)});
+
+            create_font_atlas(*font, character_atlas); // NOTE all other glyphs are rasterized on first use
 
-            console("PFont      : created atlas");
+            console("PFont      : created ", font->signed_distance_field ? "signed distance field " : "", "atlas");
             console("atlas size : ", width, "×", height);
             textSize(font_size);
-            textLeading(font_size * 1.2f);
+            textLeading(this->font_size * 1.2f); // NOTE leading is in atlas units and scaled with text size
 #ifdef PFONT_DEBUG_FONT
             DEBUG_save_font_atlas(*font, font_filepath + "--font_atlas.png");
             DEBUG_save_text(*font, "AVTAWaToVAWeYoyo Hamburgefonts", font_filepath + "--text.png");
@@ -100,8 +133,12 @@ namespace umfeld {
         }
 
         static constexpr int atlas_pixel_width       = 512;
+        static constexpr int atlas_max_page_size     = 4096;
         static constexpr int atlas_character_padding = 2;
-        const float          font_size;
+        static constexpr int sdf_font_size           = 64; // NOTE minimum raster size of signed distance field glyphs
+        static constexpr int sdf_spread              = 8;  // NOTE distance range in pixels of raster size
+        static constexpr int NO_PAGE                 = -1;
+        const float          font_size;                    // NOTE size glyphs are rasterized at
 
         static PImage* create_image(const std::string& text) {
             error("PImage / implement `create_image`: ", text);
@@ -149,19 +186,124 @@ namespace umfeld {
                 return 0.0f;
             }
 
-            const float text_scale = text_size / font_size;
-            return get_text_width(*font, str) * text_scale;
+            return glyph_run(str).width * text_scale();
         }
 
         void textSize(const float size) {
             text_size = size;
         }
 
+        /**
+         * shaped and laid out text ready to be submitted as triangles. vertices are stored as `( x, y, u, v )`
+         * in font units ( i.e unscaled by `text_size` ) with alignment and leading already applied, six
+         * vertices ( two triangles ) per glyph. glyphs on different atlas pages must be drawn with the
+         * respective page texture ( see `atlas_page()` ).
+         */
+        struct GlyphRun {
+            struct PageRange {
+                int    page;
+                size_t first;
+                size_t count;
+            };
+            std::vector<glm::vec4> vertices;
+            std::vector<PageRange> page_ranges; // NOTE vertices are grouped by atlas page
+            float                  width{0};
+        };
+
+        /**
+         * @return glyph run for `text` with the current alignment and leading. runs are cached ( least
+         *         recently used runs are evicted ) so static text is only shaped once. the reference stays
+         *         valid until the next call.
+         */
+        const GlyphRun& glyph_run(const std::string& text) const {
+            glyph_run_lookup_key.text    = text;
+            glyph_run_lookup_key.align_x = text_align_x;
+            glyph_run_lookup_key.align_y = text_align_y;
+            glyph_run_lookup_key.leading = text_leading;
+            const auto it = glyph_run_lookup.find(glyph_run_lookup_key);
+            if (it != glyph_run_lookup.end()) {
+                glyph_runs.splice(glyph_runs.begin(), glyph_runs, it->second); // NOTE mark as most recently used
+                return it->second->second;
+            }
+            glyph_runs.emplace_front(glyph_run_lookup_key, GlyphRun{});
+            create_glyph_run(text, glyph_runs.front().second);
+            glyph_run_lookup.emplace(glyph_run_lookup_key, glyph_runs.begin());
+            if (glyph_runs.size() > glyph_run_cache_capacity) {
+                glyph_run_lookup.erase(glyph_runs.back().first);
+                glyph_runs.pop_back();
+            }
+            return glyph_runs.front().second;
+        }
+
+        bool is_signed_distance_field() const {
+            return font != nullptr && font->signed_distance_field;
+        }
+
+        float text_scale() const {
+            return font_size == 0 ? 0.0f : text_size / font_size;
+        }
+
+        /**
+         * @return image of atlas page `page`. the first page is the font itself.
+         */
+        PImage* atlas_page(const int page) const {
+            if (font == nullptr || page < 0 || page >= static_cast<int>(font->pages.size())) {
+                return nullptr;
+            }
+            return font->pages[page].image;
+        }
+
+        int atlas_page_count() const {
+            return font == nullptr ? 0 : static_cast<int>(font->pages.size());
+        }
+
+        /**
+         * uploads glyphs rasterized since the last update to the atlas page textures. only the region
+         * that changed is uploaded. pages without texture are skipped, they are uploaded completely
+         * once the texture is created.
+         */
+        void update_atlas(PGraphics* g) const {
+            if (font == nullptr || g == nullptr) {
+                return;
+            }
+            for (auto& page: font->pages) {
+                if (page.dirty_x1 <= page.dirty_x0 || page.dirty_y1 <= page.dirty_y0) {
+                    continue;
+                }
+                if (page.image->texture_id >= TEXTURE_VALID_ID) {
+                    const int       region_width  = page.dirty_x1 - page.dirty_x0;
+                    const int       region_height = page.dirty_y1 - page.dirty_y0;
+                    const uint32_t* region        = page.image->pixels + page.dirty_y0 * font->page_size + page.dirty_x0;
+                    g->upload_texture(page.image, region, region_width, region_height, page.dirty_x0, page.dirty_y0, true, font->page_size);
+                }
+                page.reset_dirty_region();
+            }
+        }
+
+        void set_glyph_run_cache_capacity(const size_t capacity) {
+            glyph_run_cache_capacity = std::max<size_t>(capacity, 1);
+            while (glyph_runs.size() > glyph_run_cache_capacity) {
+                glyph_run_lookup.erase(glyph_runs.back().first);
+                glyph_runs.pop_back();
+            }
+        }
+
+        void clear_glyph_run_cache() const {
+            glyph_run_lookup.clear();
+            glyph_runs.clear();
+        }
+
         void textLeading(const float leading) {
             text_leading = leading;
         }
 
         ~PFont() override {
+            for (const auto& page: font->pages) {
+                if (page.owned) {
+                    delete[] page.image->pixels;
+                    delete page.image;
+                }
+            }
             hb_buffer_destroy(font->buffer);
             hb_font_destroy(font->hb_font);
             FT_Done_Face(font->face);
@@ -172,36 +314,91 @@ namespace umfeld {
 
     private:
         struct Glyph {
-            std::vector<unsigned char> bitmap;
-            int                        width{};
-            int                        height{};
-            int                        left{};
-            int                        top{};
-            int                        advance{};
-            int                        atlas_x{};
-            int                        atlas_y{};
+            int width{};
+            int height{};
+            int left{};
+            int top{};
+            int advance{};
+            int page{NO_PAGE}; // NOTE glyphs without bitmap ( e.g space ) are not in the atlas
+            int atlas_x{};
+            int atlas_y{};
+        };
+
+        struct AtlasPage {
+            PImage*       image{nullptr};
+            bool          owned{true};
+            SkylinePacker packer;
+            int           dirty_x0{std::numeric_limits<int>::max()};
+            int           dirty_y0{std::numeric_limits<int>::max()};
+            int           dirty_x1{0};
+            int           dirty_y1{0};
+
+            void add_dirty_region(const int x, const int y, const int w, const int h) {
+                dirty_x0 = std::min(dirty_x0, x);
+                dirty_y0 = std::min(dirty_y0, y);
+                dirty_x1 = std::max(dirty_x1, x + w);
+                dirty_y1 = std::max(dirty_y1, y + h);
+            }
+
+            void reset_dirty_region() {
+                dirty_x0 = std::numeric_limits<int>::max();
+                dirty_y0 = std::numeric_limits<int>::max();
+                dirty_x1 = 0;
+                dirty_y1 = 0;
+            }
         };
 
         struct FontData {
-            std::unordered_map<uint32_t, Glyph> glyphs;
+            std::unordered_map<uint32_t, Glyph> glyphs; // NOTE keyed by glyph index
+            std::vector<AtlasPage>              pages;
+            int                                 page_size{atlas_pixel_width};
+            bool                                signed_distance_field{false};
             int                                 ascent{};
             int                                 descent{};
             int                                 line_gap{};
-            int                                 atlas_width{};
-            int                                 atlas_height{};
-            std::vector<unsigned char>          atlas;
             FT_Face                             face{nullptr};
             hb_font_t*                          hb_font{nullptr};
             hb_buffer_t*                        buffer{nullptr};
         };
 
-        std::vector<TexturedQuad> text_quads;
-        FontData*                 font{nullptr};
-        FT_Library                freetype{nullptr};
-        float                     text_size{1};
-        float                     text_leading{0};
-        int                       text_align_x{LEFT};
-        int                       text_align_y{BASELINE};
+        struct GlyphRunKey {
+            std::string text;
+            int         align_x{LEFT};
+            int         align_y{BASELINE};
+            float       leading{0};
+
+            bool operator==(const GlyphRunKey& other) const {
+                return align_x == other.align_x &&
+                       align_y == other.align_y &&
+                       leading == other.leading &&
+                       text == other.text;
+            }
+        };
+
+        struct GlyphRunKeyHash {
+            size_t operator()(const GlyphRunKey& key) const {
+                size_t h = std::hash<std::string>{}(key.text);
+                h ^= std::hash<int>{}(key.align_x) + 0x9e3779b9 + (h << 6) + (h >> 2);
+                h ^= std::hash<int>{}(key.align_y) + 0x9e3779b9 + (h << 6) + (h >> 2);
+                h ^= std::hash<float>{}(key.leading) + 0x9e3779b9 + (h << 6) + (h >> 2);
+                return h;
+            }
+        };
+
+        using GlyphRunList = std::list<std::pair<GlyphRunKey, GlyphRun>>;
+
+        mutable std::vector<TexturedQuad>                                                 text_quads;
+        mutable GlyphRunList                                                              glyph_runs;
+        mutable std::unordered_map<GlyphRunKey, GlyphRunList::iterator, GlyphRunKeyHash> glyph_run_lookup;
+        mutable GlyphRunKey                                                               glyph_run_lookup_key; // NOTE reused to avoid allocations
+        mutable std::vector<std::vector<glm::vec4>>                                       scratch_page_vertices;
+        size_t                                                                            glyph_run_cache_capacity{1024};
+        FontData*                                                                         font{nullptr};
+        FT_Library                                                                        freetype{nullptr};
+        float                                                                             text_size{1};
+        float                                                                             text_leading{0};
+        int                                                                               text_align_x{LEFT};
+        int                                                                               text_align_y{BASELINE};
 
 #ifdef PFONT_DEBUG_FONT
         void DEBUG_save_font_atlas(const FontData& font, const std::string& output_path) const;
@@ -239,76 +436,97 @@ namespace umfeld {
             unsigned int           glyph_count;
             const hb_glyph_info_t* glyph_info = hb_buffer_get_glyph_infos(font.buffer, &glyph_count);
 
-            int           current_x      = 0;
-            int           current_y      = 0;
-            int           max_row_height = 0;
-            constexpr int atlas_width    = atlas_pixel_width;
-            int           atlas_height   = 0;
-
             for (unsigned int i = 0; i < glyph_count; i++) {
-                FT_Load_Glyph(font.face, glyph_info[i].codepoint, FT_LOAD_RENDER);
-                const FT_GlyphSlot glyph = font.face->glyph;
-
-                if (font.glyphs.find(glyph_info[i].codepoint) == font.glyphs.end()) {
-                    Glyph g;
-                    g.width   = static_cast<int>(glyph->bitmap.width);
-                    g.height  = static_cast<int>(glyph->bitmap.rows);
-                    g.left    = glyph->bitmap_left;
-                    g.top     = glyph->bitmap_top;
-                    g.advance = static_cast<int>(glyph->advance.x) >> 6;
-
-                    // Ensure correct copying of bitmap buffer
-                    if (glyph->bitmap.buffer) {
-                        g.bitmap.assign(glyph->bitmap.buffer, glyph->bitmap.buffer + g.width * g.height);
-                    } else {
-                        g.bitmap.assign(g.width * g.height, 0);
-                    }
-
-                    if (current_x + g.width + atlas_character_padding > atlas_width) {
-                        current_x = 0;
-                        current_y += max_row_height + atlas_character_padding;
-                        max_row_height = 0;
-                    }
-
-                    g.atlas_x = current_x;
-                    g.atlas_y = current_y;
+                find_or_create_glyph(font, glyph_info[i].codepoint);
+            }
+        }
 
-                    current_x += g.width + atlas_character_padding;
-                    max_row_height = std::max(max_row_height, g.height);
+        /**
+         * @return glyph for glyph index `glyph_id`. glyphs are rasterized on first use and packed into
+         *         the first atlas page with enough space. a new page is added if no page has space left.
+         */
+        static const Glyph& find_or_create_glyph(FontData& font, const uint32_t glyph_id) {
+            const auto it = font.glyphs.find(glyph_id);
+            if (it != font.glyphs.end()) {
+                return it->second;
+            }
 
-                    font.glyphs[glyph_info[i].codepoint] = g;
+            Glyph&   g          = font.glyphs[glyph_id];
+            FT_Error load_error = 0;
+            if (font.signed_distance_field) {
+#ifdef PFONT_SUPPORTS_SDF
+                load_error = FT_Load_Glyph(font.face, glyph_id, FT_LOAD_DEFAULT);
+                if (load_error == 0) {
+                    load_error = FT_Render_Glyph(font.face->glyph, FT_RENDER_MODE_SDF); // NOTE bitmap includes spread on all sides
                 }
+#endif // PFONT_SUPPORTS_SDF
+            } else {
+                load_error = FT_Load_Glyph(font.face, glyph_id, FT_LOAD_RENDER);
+            }
+            if (load_error != 0) {
+                warning("PFont: could not load glyph ", glyph_id);
+                return g;
+            }
+            const FT_GlyphSlot glyph = font.face->glyph;
+            g.width                  = static_cast<int>(glyph->bitmap.width);
+            g.height                 = static_cast<int>(glyph->bitmap.rows);
+            g.left                   = glyph->bitmap_left;
+            g.top                    = glyph->bitmap_top;
+            g.advance                = static_cast<int>(glyph->advance.x) >> 6;
+
+            if (g.width == 0 || g.height == 0 || glyph->bitmap.buffer == nullptr) {
+                return g;
+            }
+            if (!pack_glyph(font, g)) {
+                warning("PFont: glyph ", glyph_id, " does not fit into atlas page ( ", g.width, "×", g.height, " )");
+                return g;
             }
 
-            atlas_height      = current_y + max_row_height; // Fix last row height
-            font.atlas_width  = atlas_width;
-            font.atlas_height = atlas_height;
-            font.atlas.resize(atlas_width * atlas_height, 0);
-
-            for (const auto& pair: font.glyphs) {
-                const Glyph& g = pair.second;
-                for (int y = 0; y < g.height; y++) {
-                    for (int x = 0; x < g.width; x++) {
-                        const int atlas_x                           = g.atlas_x + x;
-                        const int atlas_y                           = g.atlas_y + y;
-                        font.atlas[atlas_y * atlas_width + atlas_x] = g.bitmap[y * g.width + x];
-                    }
+            AtlasPage&     page       = font.pages[g.page];
+            unsigned char* page_bytes = reinterpret_cast<unsigned char*>(page.image->pixels);
+            for (int y = 0; y < g.height; y++) {
+                const unsigned char* row = glyph->bitmap.buffer + y * glyph->bitmap.pitch;
+                for (int x = 0; x < g.width; x++) {
+                    const int idx       = ((g.atlas_y + y) * font.page_size + g.atlas_x + x) * 4;
+                    page_bytes[idx + 3] = row[x]; // NOTE RGB is already white
                 }
             }
+            page.add_dirty_region(g.atlas_x, g.atlas_y, g.width, g.height);
+            return g;
         }
 
-        static void copy_atlas_to_rgba(const FontData& font, unsigned char* atlas_rgba) {
-            for (int y = 0; y < font.atlas_height; y++) {
-                for (int x = 0; x < font.atlas_width; x++) {
-                    const unsigned char val = font.atlas[y * font.atlas_width + x];
-                    const int           idx = (y * font.atlas_width + x) * 4;
-                    // Store grayscale value into RGBA format (transparent text on white fond)
-                    atlas_rgba[idx + 0] = 255; // R
-                    atlas_rgba[idx + 1] = 255; // G
-                    atlas_rgba[idx + 2] = 255; // B
-                    atlas_rgba[idx + 3] = val; // A (fully opaque)
+        static bool pack_glyph(FontData& font, Glyph& g) {
+            const int padded_width  = g.width + atlas_character_padding;
+            const int padded_height = g.height + atlas_character_padding;
+            if (padded_width > font.page_size || padded_height > font.page_size) {
+                return false;
+            }
+            for (size_t i = 0; i < font.pages.size(); ++i) {
+                if (font.pages[i].packer.pack(padded_width, padded_height, g.atlas_x, g.atlas_y)) {
+                    g.page = static_cast<int>(i);
+                    return true;
                 }
             }
+            auto* image = new PImage(font.page_size, font.page_size, 4);
+            clear_page_pixels(image->pixels, font.page_size);
+            font.pages.push_back({image, true, SkylinePacker(font.page_size, font.page_size)});
+            console("PFont      : added atlas page ", font.pages.size(), " ( ", font.page_size, "×", font.page_size, " )");
+            if (font.pages.back().packer.pack(padded_width, padded_height, g.atlas_x, g.atlas_y)) {
+                g.page = static_cast<int>(font.pages.size() - 1);
+                return true;
+            }
+            return false;
+        }
+
+        static void clear_page_pixels(uint32_t* pixels, const int page_size) {
+            auto* bytes = reinterpret_cast<unsigned char*>(pixels);
+            for (int i = 0; i < page_size * page_size; i++) {
+                // Store grayscale value into RGBA format (transparent text on white fond)
+                bytes[i * 4 + 0] = 255; // R
+                bytes[i * 4 + 1] = 255; // G
+                bytes[i * 4 + 2] = 255; // B
+                bytes[i * 4 + 3] = 0;   // A
+            }
         }
 
         static float get_text_width(const FontData& font, const std::string& text) {
@@ -332,7 +550,7 @@ namespace umfeld {
             return width;
         }
 
-        static void generate_text_quads(const FontData&            font,
+        static void generate_text_quads(FontData&                  font,
                                         const std::string&         text,
                                         std::vector<TexturedQuad>& quads) {
             quads.clear();
@@ -349,82 +567,68 @@ namespace umfeld {
             const hb_glyph_info_t*     glyph_info = hb_buffer_get_glyph_infos(font.buffer, &glyph_count);
             const hb_glyph_position_t* glyph_pos  = hb_buffer_get_glyph_positions(font.buffer, &glyph_count);
 
-            // Dynamically decide whether to preallocate
-            if (text.length() > 100) { // Only preallocate if the text is long
-                size_t estimated_quads = 0;
-                for (unsigned int i = 0; i < glyph_count; i++) {
-                    uint32_t glyph_id = glyph_info[i].codepoint;
-                    if (glyph_id != ' ' && font.glyphs.find(glyph_id) != font.glyphs.end()) {
-                        estimated_quads++; // Only count valid glyphs (not spaces)
-                    }
-                }
-                quads.reserve(estimated_quads);
-            }
+            quads.reserve(glyph_count);
 
             float      x = 0.0f;
             const auto y = static_cast<float>(font.ascent); // Baseline position
 
             for (unsigned int i = 0; i < glyph_count; i++) {
-                uint32_t glyph_id = glyph_info[i].codepoint;
-
-                auto it = font.glyphs.find(glyph_id);
-                if (it == font.glyphs.end()) {
-                    // Handle spaces explicitly
-                    if (glyph_id == ' ') {
-                        x += static_cast<float>(glyph_pos[i].x_advance >> 6); // Move forward for spaces
-                    }
-                    continue; // Skip unsupported glyphs
+                const Glyph& g = find_or_create_glyph(font, glyph_info[i].codepoint);
+                if (g.page == NO_PAGE) {
+                    x += static_cast<float>(glyph_pos[i].x_advance >> 6); // Move forward for spaces
+                    continue;
                 }
 
-                const Glyph& g = it->second;
-
                 float      x_pos = x + static_cast<float>(g.left + (glyph_pos[i].x_offset >> 6));
                 float      y_pos = y - static_cast<float>(g.top + (glyph_pos[i].y_offset >> 6));
                 const auto w     = static_cast<float>(g.width);
                 const auto h     = static_cast<float>(g.height);
 
                 // Compute texture coordinates
-                float u0 = static_cast<float>(g.atlas_x) / static_cast<float>(font.atlas_width);
-                float v0 = static_cast<float>(g.atlas_y) / static_cast<float>(font.atlas_height);
-                float u1 = static_cast<float>(g.atlas_x + g.width) / static_cast<float>(font.atlas_width);
-                float v1 = static_cast<float>(g.atlas_y + g.height) / static_cast<float>(font.atlas_height);
+                const auto page_size = static_cast<float>(font.page_size);
+                float      u0        = static_cast<float>(g.atlas_x) / page_size;
+                float      v0        = static_cast<float>(g.atlas_y) / page_size;
+                float      u1        = static_cast<float>(g.atlas_x + g.width) / page_size;
+                float      v1        = static_cast<float>(g.atlas_y + g.height) / page_size;
 
                 // Add textured quad
                 quads.emplace_back(
                     x_pos, y_pos, u0, v0,         // Top-left
                     x_pos + w, y_pos, u1, v0,     // Top-right
                     x_pos + w, y_pos + h, u1, v1, // Bottom-right
-                    x_pos, y_pos + h, u0, v1      // Bottom-left
-                );
+                    x_pos, y_pos + h, u0, v1,     // Bottom-left
+                    g.page);
 
                 x += static_cast<float>(glyph_pos[i].x_advance >> 6); // Move forward
             }
         }
 
-        static std::vector<std::string> split_lines(const std::string& text) {
-            std::vector<std::string> lines;
-            std::istringstream       stream(text);
-            std::string              line;
-            while (std::getline(stream, line)) {
-                lines.push_back(line);
+        static void split_lines(const std::string& text, std::vector<std::string>& lines) {
+            lines.clear();
+            size_t line_start = 0;
+            while (line_start < text.size()) {
+                size_t line_end = text.find('\n', line_start);
+                if (line_end == std::string::npos) {
+                    line_end = text.size();
+                }
+                lines.emplace_back(text, line_start, line_end - line_start);
+                line_start = line_end + 1;
             }
-            return lines;
         }
 
-    public:
-        void draw(PGraphics* g, const std::string& text, const float x, const float y, const float z = 0) {
+        void create_glyph_run(const std::string& text, GlyphRun& run) const {
+            run.vertices.clear();
+            run.page_ranges.clear();
+            run.width = 0;
             if (font == nullptr) {
                 return;
             }
-            if (g == nullptr || font_size == 0) {
-                return;
-            }
 
-            const float text_scale = text_size / font_size;
-            const float ascent     = font->ascent;
-            const float descent    = font->descent;
+            const float ascent  = font->ascent;
+            const float descent = font->descent;
 
-            const std::vector<std::string> lines = split_lines(text); // see helper below
+            std::vector<std::string> lines;
+            split_lines(text, lines);
 
             float y_offset = -ascent;
 
@@ -439,15 +643,16 @@ namespace umfeld {
                     break;
             }
 
-            g->pushMatrix();
-            g->translate(x, y, z);
-            g->scale(text_scale, text_scale, 1);
-            g->translate(0, y_offset, 0);
-            g->texture(this);
+            for (auto& page_vertices: scratch_page_vertices) {
+                page_vertices.clear();
+            }
 
             for (std::size_t i = 0; i < lines.size(); ++i) {
                 const std::string& line       = lines[i];
                 const float        line_width = get_text_width(*font, line);
+                if (lines.size() == 1) {
+                    run.width = line_width;
+                }
 
                 float x_offset = 0;
                 switch (text_align_x) {
@@ -460,22 +665,67 @@ namespace umfeld {
 
                 generate_text_quads(*font, line, text_quads);
 
-                g->pushMatrix();
-                g->translate(x_offset, i * text_leading, 0); // baseline offset for current line
-                g->beginShape(TRIANGLES);
+                const float line_y = y_offset + i * text_leading; // baseline offset for current line
+                if (scratch_page_vertices.size() < font->pages.size()) {
+                    scratch_page_vertices.resize(font->pages.size());
+                }
                 for (const auto& q: text_quads) {
-                    g->vertex(q.x0, q.y0, 0, q.u0, q.v0);
-                    g->vertex(q.x1, q.y1, 0, q.u1, q.v1);
-                    g->vertex(q.x2, q.y2, 0, q.u2, q.v2);
+                    std::vector<glm::vec4>& vertices = scratch_page_vertices[q.page];
+                    vertices.emplace_back(q.x0 + x_offset, q.y0 + line_y, q.u0, q.v0);
+                    vertices.emplace_back(q.x1 + x_offset, q.y1 + line_y, q.u1, q.v1);
+                    vertices.emplace_back(q.x2 + x_offset, q.y2 + line_y, q.u2, q.v2);
+
+                    vertices.emplace_back(q.x3 + x_offset, q.y3 + line_y, q.u3, q.v3);
+                    vertices.emplace_back(q.x0 + x_offset, q.y0 + line_y, q.u0, q.v0);
+                    vertices.emplace_back(q.x2 + x_offset, q.y2 + line_y, q.u2, q.v2);
+                }
+            }
 
-                    g->vertex(q.x3, q.y3, 0, q.u3, q.v3);
-                    g->vertex(q.x0, q.y0, 0, q.u0, q.v0);
-                    g->vertex(q.x2, q.y2, 0, q.u2, q.v2);
+            for (size_t page = 0; page < scratch_page_vertices.size(); ++page) {
+                const std::vector<glm::vec4>& vertices = scratch_page_vertices[page];
+                if (vertices.empty()) {
+                    continue;
                 }
-                g->endShape(CLOSE);
-                g->popMatrix();
+                run.page_ranges.push_back({static_cast<int>(page), run.vertices.size(), vertices.size()});
+                run.vertices.insert(run.vertices.end(), vertices.begin(), vertices.end());
+            }
+
+            if (lines.size() > 1) {
+                run.width = get_text_width(*font, text); // NOTE width is measured over the whole string ( as `textWidth` always did )
+            }
+        }
+
+    public:
+        /**
+         * draws text with `beginShape(TRIANGLES)`. renderers that batch text ( see `PGraphics::text_str` )
+         * use `glyph_run()` directly.
+         */
+        void draw(PGraphics* g, const std::string& text, const float x, const float y, const float z = 0) {
+            if (font == nullptr) {
+                return;
+            }
+            if (g == nullptr || font_size == 0) {
+                return;
             }
 
+            const GlyphRun& run = glyph_run(text);
+            if (run.vertices.empty()) {
+                return;
+            }
+            update_atlas(g);
+
+            g->pushMatrix();
+            g->translate(x, y, z);
+            g->scale(text_scale(), text_scale(), 1);
+            for (const auto& range: run.page_ranges) {
+                g->texture(atlas_page(range.page));
+                g->beginShape(TRIANGLES);
+                for (size_t i = range.first; i < range.first + range.count; ++i) {
+                    const glm::vec4& v = run.vertices[i];
+                    g->vertex(v.x, v.y, 0, v.z, v.w);
+                }
+                g->endShape(CLOSE);
+            }
             g->texture();
             g->popMatrix();
         }
@@ -608,18 +858,7 @@ namespace umfeld {
          */
         GLuint create_font_texture(const FontData& font) const {
             // TODO this does happen in OpenGL context ... as for PImage
-            std::vector<unsigned char> atlas_rgba(font.atlas_width * font.atlas_height * 4, 255);
-            for (int y = 0; y < font.atlas_height; y++) {
-                for (int x = 0; x < font.atlas_width; x++) {
-                    const unsigned char val = font.atlas[y * font.atlas_width + x];
-                    const int           idx = (y * font.atlas_width + x) * 4;
-                    // Store grayscale value into RGBA format (transparent text on white fond)
-                    atlas_rgba[idx + 0] = 255; // R
-                    atlas_rgba[idx + 1] = 255; // G
-                    atlas_rgba[idx + 2] = 255; // B
-                    atlas_rgba[idx + 3] = val; // A (fully opaque)
-                }
-            }
+            const PImage* page = font.pages[0].image; // NOTE only the first atlas page
 
             GLuint texture_id;
             glGenTextures(1, &texture_id);
@@ -638,12 +877,11 @@ namespace umfeld {
             glTexImage2D(GL_TEXTURE_2D,
                          0,
                          UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
-                         font.atlas_width, font.atlas_height,
+                         font.page_size, font.page_size,
                          0,
                          UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
                          UMFELD_DEFAULT_TEXTURE_PIXEL_TYPE,
-                         // font.atlas.data());
-                         atlas_rgba.data());
+                         page->pixels);
 
             // Unbind for safety
             glBindTexture(GL_TEXTURE_2D, 0);
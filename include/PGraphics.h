@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <functional>
 #include <stack>
 #include <sstream>
 #include <glm/glm.hpp>
@@ -28,6 +29,8 @@
 #include "PImage.h"
 #include "Vertex.h"
 #include "Triangulator.h"
+#include "TessellationCache.h"
+#include "StrokeTessellator.h"
 #include "UFont.h"
 
 namespace umfeld {
@@ -35,6 +38,11 @@ namespace umfeld {
     class VertexBuffer;
     class PShader;
 
+    /**
+     * receives pixels ( RGBA, rows bottom-up ) of a framebuffer readback. `pixels` may be moved from.
+     */
+    using FramebufferReadbackCallback = std::function<void(std::vector<unsigned char>& pixels, int width, int height)>;
+
     class PGraphics : public virtual PImage {
     public:
         struct FrameBufferObject {
@@ -60,6 +68,8 @@ namespace umfeld {
 
         virtual void render_framebuffer_to_screen(bool use_blit) {} // TODO this should probably go to PGraphicsOpenGL
         virtual bool read_framebuffer(std::vector<unsigned char>& pixels) { return false; }
+        virtual bool read_framebuffer_async(const FramebufferReadbackCallback& callback);
+        virtual void finish_framebuffer_readbacks() {} // NOTE completes all pending asynchronous readbacks
 
         /* --- implementation specific methods ( pure virtual ) --- */
 
@@ -76,6 +86,12 @@ namespace umfeld {
          * @param line_strip_closed
          */
         virtual void emit_shape_stroke_line_strip(std::vector<Vertex>& line_strip_vertices, bool line_strip_closed) = 0;
+        /**
+         * @brief method should emit text triangles sampling a signed distance field font atlas. renderers
+         *        without SDF support draw the distance field as is.
+         * @param triangle_vertices
+         */
+        virtual void emit_text_signed_distance_field(std::vector<Vertex>& triangle_vertices) { emit_shape_fill_triangles(triangle_vertices); }
         virtual void beginDraw();
         virtual void endDraw();
         virtual void reset_mvp_matrices();
@@ -135,6 +151,7 @@ namespace umfeld {
         virtual void endShape(bool close_shape = false);
         virtual void vertex(float x, float y, float z = 0.0f);
         virtual void vertex(float x, float y, float z, float u, float v);
+        virtual void polygons(const std::vector<std::vector<glm::vec3>>& outlines, bool close_shape = true); // NOTE like `beginShape(POLYGON)` + `endShape()` for each outline
 
         // ## Structure
 
@@ -192,7 +209,12 @@ namespace umfeld {
         /* --- additional --- */
 
         virtual void        mesh(VertexBuffer* mesh_shape) {}
-        virtual void        upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped) {}
+        virtual void        beginInstances();
+        void                instance(); // NOTE records current model matrix and fill color
+        void                instance(const glm::mat4& transform, const glm::vec4& color);
+        virtual void        endInstances(VertexBuffer* mesh_shape);
+        virtual void        endInstances(int instance_shape); // NOTE RECT, ELLIPSE, BOX or SPHERE with unit size
+        virtual void        upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped, int pixel_data_row_length = 0) {} // NOTE `pixel_data_row_length` is the distance between rows in pixels ( `0` for `width` ) e.g to upload a sub-rectangle of a larger image without copying it first
         virtual void        download_texture(PImage* img) {}
         virtual void        lock_init_properties(const bool lock_properties) { init_properties_locked = lock_properties; }
         virtual void        hint(uint16_t property);
@@ -205,7 +227,7 @@ namespace umfeld {
         int                 getPixelDensity() const { return pixel_density; }
         void                stroke_mode(const int line_render_mode) { this->line_render_mode = line_render_mode; }
         void                stroke_properties(float stroke_join_round_resolution, float stroke_cap_round_resolution, float stroke_join_miter_max_angle);
-        void                triangulate_line_strip_vertex(const std::vector<Vertex>& line_strip, bool close_shape, std::vector<Vertex>& line_vertices) const;
+        void                triangulate_line_strip_vertex(const std::vector<Vertex>& line_strip, bool close_shape, std::vector<Vertex>& line_vertices);
         virtual void        set_default_graphics_state() {}
         void                set_render_mode(const int render_mode) { this->render_mode = render_mode; }
         virtual std::string name() { return "PGraphics"; }
@@ -220,6 +242,9 @@ namespace umfeld {
         static std::vector<Vertex> triangulate_faster(const std::vector<Vertex>& vertices);
         static std::vector<Vertex> triangulate_better_quality(const std::vector<Vertex>& vertices);
         static std::vector<Vertex> triangulate_good(const std::vector<Vertex>& vertices);
+        static std::vector<Vertex> triangulate(const std::vector<Vertex>& vertices, int polygon_triangulation_strategy);
+        static void                triangulate(const std::vector<Vertex>& vertices, int polygon_triangulation_strategy, TessellationCache::Triangles& triangles);
+        const TessellationCache&   get_tessellation_cache() const { return tessellation_cache; }
 
     protected:
         struct ColorState : glm::vec4 {
@@ -263,7 +288,6 @@ namespace umfeld {
         float                            stroke_join_round_resolution{glm::radians(20.0f)}; // TODO maybe make these configurable
         float                            stroke_cap_round_resolution{glm::radians(20.0f)};  // 20° resolution i.e 18 segment for whole circle
         float                            stroke_join_miter_max_angle{163.0f};
-        inline static const Triangulator triangulator{};
         std::vector<ColorState>          color_stroke_stack{};
         std::vector<ColorState>          color_fill_stack{};
         std::vector<glm::vec3>           box_vertices_LUT{};
@@ -272,6 +296,40 @@ namespace umfeld {
         static constexpr uint32_t        VBO_BUFFER_CHUNK_SIZE{1024 * 1024}; // 1MB
         std::vector<Vertex>              shape_stroke_vertex_buffer{VBO_BUFFER_CHUNK_SIZE};
         std::vector<Vertex>              shape_fill_vertex_buffer{VBO_BUFFER_CHUNK_SIZE};
+        // NOTE scratch buffers are reused across shapes ( cleared, never shrunk ) so that the emit path does not allocate
+        std::vector<Vertex>              scratch_fill_triangles{};
+        TessellationCache::Triangles     scratch_tessellated_vertices{};
+        TessellationCache                tessellation_cache{};
+        StrokeTessellator                stroke_tessellator{};
+        bool                             tessellation_cache_enabled{true};
+        std::vector<std::vector<Vertex>> scratch_polygon_outlines{};
+        std::vector<std::vector<Vertex>> scratch_polygon_triangles{};
+        std::vector<Vertex>              scratch_polygon_stroke{};
+        std::vector<Vertex>              scratch_stroke_primitives{};
+        std::vector<Vertex>              scratch_stroke_line{};
+        std::vector<glm::vec2>           scratch_line_strip_points{};
+        std::vector<glm::vec2>           scratch_line_strip_triangles{};
+        bool                             depth_sort_translucent{false};
+        std::vector<Vertex>              translucent_vertices{};    // NOTE world space, three vertices per triangle
+        std::vector<int>                 translucent_texture_ids{}; // NOTE one per triangle
+        std::vector<float>               translucent_depths{};
+        std::vector<uint32_t>            translucent_sort_keys{};
+        std::vector<uint32_t>            translucent_sort_indices{};
+        std::vector<uint32_t>            scratch_sort_keys{};
+        std::vector<uint32_t>            scratch_sort_indices{};
+        std::vector<Vertex>              scratch_translucent_vertices{};
+        struct TextBatch {
+            PImage*             texture{nullptr}; // NOTE font atlas page
+            bool                signed_distance_field{false};
+            std::vector<Vertex> vertices{}; // NOTE world space
+        };
+        bool                             signed_distance_field_fonts{false};
+        bool                             text_batching{false};
+        bool                             text_batch_flushing{false};
+        std::vector<TextBatch>           text_batches{};
+        std::vector<InstanceData>        instances{};
+        std::vector<Vertex>              scratch_instance_vertices{};
+        bool                             instances_begun{false};
         int                              last_bound_texture_id_cache{TEXTURE_NONE};
         bool                             model_matrix_dirty{false};
         glm::vec4                        current_normal{Vertex::DEFAULT_NORMAL};
@@ -330,5 +388,17 @@ namespace umfeld {
         }
 
         void resize_ellipse_points_LUT();
+        void generate_instance_shape(int instance_shape, std::vector<Vertex>& vertices) const;
+
+        void tessellate_polygon(const std::vector<Vertex>& outline, std::vector<Vertex>& triangle_vertices);
+        void tessellate_polygons(const std::vector<std::vector<Vertex>>& outlines, std::vector<std::vector<Vertex>>& triangle_vertices);
+
+        static bool has_translucent_vertices(const std::vector<Vertex>& vertices);
+        void        translucent_enqueue(const std::vector<Vertex>& triangle_vertices);
+        void        translucent_flush();
+        void        translucent_discard();
+        void                 text_flush();
+        void                 text_discard();
+        std::vector<Vertex>& text_batch(PImage* texture, bool signed_distance_field);
     };
 } // namespace umfeld
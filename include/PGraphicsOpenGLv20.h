@@ -42,7 +42,7 @@ namespace umfeld {
         void bind_fbo() override;
         void finish_fbo() override;
 
-        void upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped) override;
+        void upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped, int pixel_data_row_length = 0) override;
         void download_texture(PImage* img) override;
 
         void beginDraw() override;
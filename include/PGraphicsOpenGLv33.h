@@ -19,30 +19,51 @@
 
 #pragma once
 
+#include <deque>
+#include <unordered_map>
+
 #include "PGraphicsOpenGL.h"
+#include "PShader.h"
 
 namespace umfeld {
     class PGraphicsOpenGLv33 final : public PGraphicsOpenGL {
     public:
         explicit PGraphicsOpenGLv33(bool render_to_offscreen);
 
+        /**
+         * counters for the streaming vertex buffer. `stalls_avoided` counts uploads that were
+         * appended behind data that might still be in use by the GPU ( i.e uploads that would
+         * have overwritten the beginning of the buffer before ).
+         */
+        struct VertexStreamingStats {
+            uint64_t bytes_streamed{0};
+            uint64_t uploads{0};
+            uint64_t stalls_avoided{0};
+            uint64_t buffer_orphans{0};
+            uint64_t buffer_reallocations{0};
+        };
+
         /* --- OpenGL 3.3 specific implementation of shared methods --- */
 
         void emit_shape_stroke_line_strip(std::vector<Vertex>& line_strip_vertices, bool line_strip_closed) override;
         void emit_shape_fill_triangles(std::vector<Vertex>& triangle_vertices) override;
+        void emit_text_signed_distance_field(std::vector<Vertex>& triangle_vertices) override;
 
         void IMPL_background(float a, float b, float c, float d) override;
         void IMPL_bind_texture(int bind_texture_id) override;
         void IMPL_set_texture(PImage* img) override;
+        void blendMode(int mode) override;
 
         void render_framebuffer_to_screen(bool use_blit = false) override;
         bool read_framebuffer(std::vector<unsigned char>& pixels) override;
+        bool read_framebuffer_async(const FramebufferReadbackCallback& callback) override;
+        void finish_framebuffer_readbacks() override;
         void store_fbo_state() override;
         void restore_fbo_state() override;
         void bind_fbo() override;
         void finish_fbo() override {}
 
-        void upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped) override;
+        void upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped, int pixel_data_row_length = 0) override;
         void download_texture(PImage* img) override;
 
         void beginDraw() override;
@@ -57,6 +78,8 @@ namespace umfeld {
         /* --- standard drawing functions --- */
 
         void     mesh(VertexBuffer* mesh_shape) override;
+        void     endInstances(VertexBuffer* mesh_shape) override;
+        void     endInstances(int instance_shape) override;
         void     shader(PShader* shader) override;
         PShader* loadShader(const std::string& vertex_code, const std::string& fragment_code, const std::string& geometry_code = "") override;
         void     resetShader() override;
@@ -65,49 +88,164 @@ namespace umfeld {
         void     ortho(float left, float right, float bottom, float top, float near, float far) override;
         void     perspective(float fovy, float aspect, float near, float far) override;
 
+        /* --- additional --- */
+
+        const VertexStreamingStats& vertex_streaming_stats() const { return current_vertex_buffer().stats; }
+        void                        reset_vertex_streaming_stats() {
+            vertex_buffer_data.stats        = {};
+            vertex_buffer_data_packed.stats = {};
+        }
+        bool packed_vertices() const { return use_packed_vertices; }
+
     private:
         struct RenderBatch {
             int    start_index;
             int    num_vertices;
             GLuint texture_id;
+            GLenum primitive_mode;
 
-            RenderBatch(const int start, const int count, const GLuint texID)
-                : start_index(start), num_vertices(count), texture_id(texID) {}
+            RenderBatch(const int start, const int count, const GLuint texID, const GLenum mode)
+                : start_index(start), num_vertices(count), texture_id(texID), primitive_mode(mode) {}
         };
 
-        struct VertexBufferData {
-            GLuint              VAO{0};
-            GLuint              VBO{0};
-            std::vector<Vertex> vertices{};
-            const uint32_t      num_vertices;
-            explicit VertexBufferData(const uint32_t vertex_count) : num_vertices(vertex_count) {
-                vertices.resize(vertex_count);
+        /**
+         * render targets for weighted blended order-independent transparency.
+         */
+        struct OITBuffers {
+            GLuint   FBO{0};
+            GLuint   accumulation_texture{0};
+            GLuint   weight_texture{0};
+            GLuint   depth_renderbuffer{0};
+            GLuint   VAO{0}; // NOTE empty VAO for fullscreen triangle
+            int      width{0};
+            int      height{0};
+            PShader* accumulate_shader{nullptr};
+            PShader* composite_shader{nullptr};
+            bool     uninitialized() const {
+                return FBO == 0;
             }
+        };
+
+        /**
+         * streaming vertex buffer. vertices are appended behind the previous upload and the buffer
+         * is orphaned once it is full, so that consecutive draws never overwrite data the GPU might
+         * still read from.
+         */
+        struct VertexBufferData {
+            GLuint               VAO{0};
+            GLuint               VBO{0};
+            uint32_t             capacity;        // NOTE in vertices
+            uint32_t             write_offset{0}; // NOTE in vertices
+            bool                 packed;          // NOTE stores `PackedVertex` instead of `Vertex`
+            VertexStreamingStats stats{};
+            explicit VertexBufferData(const uint32_t vertex_count, const bool packed = false) : capacity(vertex_count), packed(packed) {}
             bool uninitialized() const {
                 return VAO == 0 || VBO == 0;
             }
+            uint32_t stride() const {
+                return packed ? sizeof(PackedVertex) : sizeof(Vertex);
+            }
+        };
+
+        /**
+         * ring of pixel buffer objects for texture uploads. pixels are copied into the next buffer in
+         * the ring and transferred to the texture by the driver without blocking the draw thread.
+         * cycling through several buffers avoids waiting for a transfer that is still in flight.
+         */
+        struct PixelUnpackBuffers {
+            static constexpr int NUM_BUFFERS = 3;
+            GLuint               PBO[NUM_BUFFERS]{};
+            GLsizeiptr           size[NUM_BUFFERS]{};
+            int                  index{0};
         };
 
+        /**
+         * framebuffer read into a pixel pack buffer. the fence signals when the transfer is done.
+         */
+        struct FramebufferReadback {
+            GLuint                      PBO{0};
+            GLsync                      fence{nullptr};
+            int                         width{0};
+            int                         height{0};
+            FramebufferReadbackCallback callback;
+        };
+
+        using InstanceShapeMeshes = std::unordered_map<int, VertexBuffer*>;
+
         static constexpr bool     RENDER_POINT_AS_CIRCLE                 = true;
         static constexpr bool     RENDER_PRIMITVES_AS_SHAPES             = true;
         static constexpr uint8_t  NUM_FILL_VERTEX_ATTRIBUTES_XYZ_RGBA_UV = 9;
         static constexpr uint8_t  NUM_STROKE_VERTEX_ATTRIBUTES_XYZ_RGBA  = 7;
         static constexpr uint32_t VBO_BUFFER_CHUNK_SIZE                  = 1024 * 1024; // 1MB
+        static constexpr int      PBO_UPLOAD_MIN_BYTES                   = 256 * 1024;  // NOTE smaller uploads ( e.g font atlas regions ) are uploaded directly
+        static constexpr size_t   MAX_PENDING_FRAMEBUFFER_READBACKS      = 3;           // NOTE requesting more readbacks waits for the oldest one
+        static constexpr uint64_t FRAMEBUFFER_READBACK_TIMEOUT_NS        = 1000000000;  // 1sec
         GLuint                    texture_id_solid_color{};
         VertexBufferData          vertex_buffer_data{VBO_BUFFER_CHUNK_SIZE};
-        std::vector<RenderBatch>  renderBatches; // TODO revive for buffered mode
+        VertexBufferData          vertex_buffer_data_packed{VBO_BUFFER_CHUNK_SIZE, true};
+        bool                      use_packed_vertices{false};
+        std::vector<PackedVertex> scratch_packed_vertices{};
+        PShader*                  instanced_shader{nullptr};
+        PShader*                  stroke_shader{nullptr}; // NOTE expands `GL_LINES_ADJACENCY` segments in a geometry shader
+        PShader*                  sdf_shader{nullptr};    // NOTE renders signed distance field fonts
+        GLuint                    instance_VBO{0};
+        PixelUnpackBuffers        pixel_unpack_buffers{};
+        InstanceShapeMeshes       instance_shape_meshes{};          // NOTE unit shapes by shape type, generated on first use
+        size_t                    instance_shape_ellipse_detail{0}; // NOTE number of ellipse points the cached ellipse was generated with
+        int                       blend_mode_current{BLEND};
+        bool                      oit_enabled{false};
+        OITBuffers                oit{};
+        std::vector<Vertex>       oit_vertices;
+        std::vector<RenderBatch>  oit_batches;
+        std::vector<RenderBatch>  renderBatches;
+        std::vector<Vertex>       buffered_vertices; // NOTE collected in world space, flushed in `endDraw()`
+        std::vector<Vertex>       scratch_transformed_vertices{}; // NOTE scratch buffers are reused to avoid per-shape allocations
+        std::vector<Vertex>       scratch_stroke_vertices{};
         GLint                     previously_bound_read_FBO = 0;
         GLint                     previously_bound_draw_FBO = 0;
         GLint                     previous_viewport[4]{};
         GLint                     previous_shader{0};
+        GLint                     previous_matrices_UBO{0};
+        GLuint                    matrices_UBO{0}; // NOTE backs the `uMatrices` block shared by all built-in shaders
+        glm::mat4                 matrices_UBO_projection{0.0f};
+        glm::mat4                 matrices_UBO_view{0.0f};
+        PShader::UniformHandle    default_shader_model_matrix{};
+
+        std::deque<FramebufferReadback> framebuffer_readbacks; // NOTE in order of request
+        std::vector<GLuint>             framebuffer_readback_PBOs;
 
         /* --- OpenGL 3.3 specific methods --- */
 
-        void        OGL3_tranform_model_matrix_and_render_vertex_buffer(VertexBufferData& vertex_buffer, GLenum mode, const std::vector<Vertex>& shape_vertices) const;
-        static void OGL3_resize_vertex_buffer(size_t buffer_size_bytes);
-        static void OGL3_init_vertex_buffer(VertexBufferData& vertex_buffer);
-        void        OGL3_create_solid_color_texture();
-        static void OGL3_render_vertex_buffer(VertexBufferData& vertex_buffer, GLenum primitive_mode, const std::vector<Vertex>& shape_vertices);
-        void        update_shader_view_matrix() const;
+        void         OGL3_tranform_model_matrix_and_render_vertex_buffer(VertexBufferData& vertex_buffer, GLenum mode, const std::vector<Vertex>& shape_vertices);
+        GLint        OGL3_stream_vertex_buffer(VertexBufferData& vertex_buffer, const std::vector<Vertex>& shape_vertices);
+        static void  OGL3_init_vertex_buffer(VertexBufferData& vertex_buffer);
+        void         OGL3_create_solid_color_texture();
+        void         OGL3_render_vertex_buffer(VertexBufferData& vertex_buffer, GLenum primitive_mode, const std::vector<Vertex>& shape_vertices);
+        void         update_shader_view_matrix();
+        void         OGL3_update_matrices_UBO();
+        void         OGL3_set_view_projection_matrix(PShader* shader) const;
+        void         OGL3_set_default_shader_model_matrix(const glm::mat4& matrix) const;
+        void         OGL3_upload_instance_buffer();
+        bool         OGL3_stage_pixel_unpack_buffer(const uint32_t* pixel_data, int pixel_data_row_length, int width, int height);
+        void         OGL3_bind_framebuffer_for_reading() const;
+        bool         OGL3_complete_framebuffer_readback(bool wait);
+        void         OGL3_line_strip_to_adjacency(const std::vector<Vertex>& line_strip, bool line_strip_closed, std::vector<Vertex>& adjacency_vertices) const;
+        void         OGL3_use_stroke_shader(const glm::mat4& transform) const;
+        VertexBufferData&       current_vertex_buffer() { return use_packed_vertices ? vertex_buffer_data_packed : vertex_buffer_data; }
+        const VertexBufferData& current_vertex_buffer() const { return use_packed_vertices ? vertex_buffer_data_packed : vertex_buffer_data; }
+
+        /* --- buffered mode --- */
+
+        void RM_add_vertices(GLenum primitive_mode, const std::vector<Vertex>& vertices, bool transform_to_world_space);
+        void RM_add_line_strip(const std::vector<Vertex>& line_strip_vertices, bool line_strip_closed);
+        void RM_flush();
+        void RM_discard();
+
+        /* --- order-independent transparency --- */
+
+        void        OIT_add_vertices(const std::vector<Vertex>& vertices);
+        void        OIT_init_buffers(int width, int height);
+        void        OIT_resolve();
+        void        OIT_discard();
     };
 } // namespace umfeld
@@ -19,17 +19,41 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <GL/glew.h>
 
 namespace umfeld {
+    /**
+     * uniform locations are resolved once after linking. values are shadowed per uniform so that setting
+     * a uniform to its current value does not issue a GL call. setting uniforms requires the shader to
+     * be in use ( i.e `use()` ).
+     */
     class PShader {
     public:
+        /**
+         * pre-resolved uniform. handles are only valid for the shader that created them.
+         */
+        struct UniformHandle {
+            int index{-1};
+        };
+
         PShader();
         ~PShader();
 
+        UniformHandle get_uniform_handle(const std::string& name);
+        void          set_uniform(UniformHandle handle, int value);
+        void          set_uniform(UniformHandle handle, int value_a, int value_b);
+        void          set_uniform(UniformHandle handle, float value);
+        void          set_uniform(UniformHandle handle, float value_a, float value_b);
+        void          set_uniform(UniformHandle handle, const glm::vec2& value);
+        void          set_uniform(UniformHandle handle, const glm::vec3& value);
+        void          set_uniform(UniformHandle handle, const glm::vec4& value);
+        void          set_uniform(UniformHandle handle, const glm::mat4& value);
+
         void set_uniform(const std::string& name, int value);
         void set_uniform(const std::string& name, int value_a, int value_b);
         void set_uniform(const std::string& name, float value);
@@ -44,14 +68,30 @@ namespace umfeld {
         void        use() const;
         static void unuse();
         GLuint      get_program_id() const { return programID; }
+        /**
+         * @return true if the shader declares the shared uniform block `SHADER_UNIFORM_BLOCK_MATRICES`. the
+         *         projection and view matrices are then provided by the renderer's uniform buffer and must
+         *         not be set as individual uniforms.
+         */
+        bool uses_matrix_block() const { return has_matrix_block; }
 
     private:
-        GLuint                                 programID;
-        std::unordered_map<std::string, GLint> uniformLocations;
+        struct Uniform {
+            GLint                 location{-1};
+            bool                  has_value{false};
+            std::array<float, 16> value{};
+        };
+
+        GLuint                               programID;
+        bool                                 has_matrix_block{false};
+        std::vector<Uniform>                 uniforms;
+        std::unordered_map<std::string, int> uniform_indices;
 
         static GLuint compileShader(const std::string& source, GLenum type);
         static void   checkCompileErrors(GLuint shader, GLenum type);
         static void   checkLinkErrors(GLuint program);
-        GLint         getUniformLocation(const std::string& name);
+        void          resolve_uniforms();
+        int           register_uniform(const std::string& name, GLint location);
+        Uniform*      changed_uniform(UniformHandle handle, const void* value, size_t size);
     };
 } // namespace umfeld
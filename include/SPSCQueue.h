@@ -0,0 +1,154 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace umfeld {
+    /**
+     * wait-free single-producer/single-consumer ring buffer with a fixed capacity. one thread may
+     * `push` ( e.g the draw thread ) while another thread may `front`/`pop` ( e.g the audio thread ).
+     * neither side ever blocks, allocates or takes a lock: `push` fails if the queue is full and
+     * `front` returns `nullptr` if it is empty.
+     *
+     * read and write index live on separate cache lines. each side keeps a cached copy of the other
+     * side's index and only reloads it when the queue appears full ( or empty ).
+     *
+     * @tparam CAPACITY number of elements, must be a power of two
+     */
+    template<typename T, size_t CAPACITY>
+    class SPSCQueue {
+        static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+    public:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        SPSCQueue()                            = default;
+        SPSCQueue(const SPSCQueue&)            = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        static constexpr size_t capacity() { return CAPACITY; }
+
+        /* --- producer --- */
+
+        bool push(const T& value) {
+            const size_t write = write_index.load(std::memory_order_relaxed);
+            if (write - cached_read_index >= CAPACITY) {
+                cached_read_index = read_index.load(std::memory_order_acquire);
+                if (write - cached_read_index >= CAPACITY) {
+                    return false;
+                }
+            }
+            buffer[write & MASK] = value;
+            write_index.store(write + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * pushes all `count` elements or none if there is not enough space
+         */
+        bool push(const T* values, const size_t count) {
+            const size_t write = write_index.load(std::memory_order_relaxed);
+            if (write + count - cached_read_index > CAPACITY) {
+                cached_read_index = read_index.load(std::memory_order_acquire);
+                if (write + count - cached_read_index > CAPACITY) {
+                    return false;
+                }
+            }
+            for (size_t i = 0; i < count; ++i) {
+                buffer[(write + i) & MASK] = values[i];
+            }
+            write_index.store(write + count, std::memory_order_release);
+            return true;
+        }
+
+        /* --- consumer --- */
+
+        /**
+         * @return pointer to the oldest element or `nullptr` if the queue is empty. the element stays
+         *         valid until `pop()` is called.
+         */
+        T* front() {
+            const size_t read = read_index.load(std::memory_order_relaxed);
+            if (read == cached_write_index) {
+                cached_write_index = write_index.load(std::memory_order_acquire);
+                if (read == cached_write_index) {
+                    return nullptr;
+                }
+            }
+            return &buffer[read & MASK];
+        }
+
+        /**
+         * removes the oldest element. must only be called after `front()` returned an element.
+         */
+        void pop() {
+            read_index.store(read_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        bool pop(T& value) {
+            T* element = front();
+            if (element == nullptr) {
+                return false;
+            }
+            value = *element;
+            pop();
+            return true;
+        }
+
+        /**
+         * removes up to `max_count` of the oldest elements and copies them to `values`
+         * @return number of elements removed
+         */
+        size_t pop(T* values, const size_t max_count) {
+            const size_t read  = read_index.load(std::memory_order_relaxed);
+            cached_write_index = write_index.load(std::memory_order_acquire);
+            const size_t count = std::min(cached_write_index - read, max_count);
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = buffer[(read + i) & MASK];
+            }
+            read_index.store(read + count, std::memory_order_release);
+            return count;
+        }
+
+        /* --- either thread --- */
+
+        /**
+         * @return number of queued elements. only a snapshot if the other thread is active.
+         */
+        size_t size() const {
+            return write_index.load(std::memory_order_acquire) - read_index.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+
+    private:
+        static constexpr size_t MASK = CAPACITY - 1;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> write_index{0};
+        size_t cached_read_index{0}; // NOTE only accessed by producer
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> read_index{0};
+        size_t cached_write_index{0}; // NOTE only accessed by consumer
+        alignas(CACHE_LINE_SIZE) std::array<T, CAPACITY> buffer{};
+    };
+} // namespace umfeld
@@ -0,0 +1,145 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace umfeld {
+    /**
+     * packs rectangles into a fixed size area with the skyline bottom-left heuristic. the skyline is the
+     * upper contour of all packed rectangles stored as horizontal segments. a new rectangle is placed
+     * on the segment where its top edge ends up lowest ( ties are broken by the narrower waste ).
+     * rectangles can not be removed individually, only by `reset()`.
+     */
+    class SkylinePacker {
+    public:
+        SkylinePacker(const int width = 0, const int height = 0) {
+            reset(width, height);
+        }
+
+        void reset(const int width, const int height) {
+            this->width  = width;
+            this->height = height;
+            skyline.clear();
+            skyline.push_back({0, 0, width});
+        }
+
+        /**
+         * @return true if a rectangle of `rect_width` × `rect_height` fits. position is returned in `x`
+         *         and `y`.
+         */
+        bool pack(const int rect_width, const int rect_height, int& x, int& y) {
+            if (rect_width <= 0 || rect_height <= 0) {
+                return false;
+            }
+            int    best_top   = std::numeric_limits<int>::max();
+            int    best_width = std::numeric_limits<int>::max();
+            size_t best_index = skyline.size();
+            for (size_t i = 0; i < skyline.size(); ++i) {
+                const int segment_y = fit(i, rect_width, rect_height);
+                if (segment_y < 0) {
+                    continue;
+                }
+                const int top = segment_y + rect_height;
+                if (top < best_top || (top == best_top && skyline[i].width < best_width)) {
+                    best_top   = top;
+                    best_width = skyline[i].width;
+                    best_index = i;
+                    x          = skyline[i].x;
+                    y          = segment_y;
+                }
+            }
+            if (best_index == skyline.size()) {
+                return false;
+            }
+            add(best_index, x, y, rect_width, rect_height);
+            return true;
+        }
+
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+    private:
+        struct Segment {
+            int x;
+            int y;
+            int width;
+        };
+
+        std::vector<Segment> skyline;
+        int                  width{0};
+        int                  height{0};
+
+        /**
+         * @return y position of a rectangle placed at segment `index` or -1 if it does not fit
+         */
+        int fit(const size_t index, const int rect_width, const int rect_height) const {
+            const int x = skyline[index].x;
+            if (x + rect_width > width) {
+                return -1;
+            }
+            int width_left = rect_width;
+            int y          = skyline[index].y;
+            for (size_t i = index; width_left > 0; ++i) {
+                if (i >= skyline.size()) {
+                    return -1;
+                }
+                y = std::max(y, skyline[i].y);
+                if (y + rect_height > height) {
+                    return -1;
+                }
+                width_left -= skyline[i].width;
+            }
+            return y;
+        }
+
+        void add(const size_t index, const int x, const int y, const int rect_width, const int rect_height) {
+            skyline.insert(skyline.begin() + index, {x, y + rect_height, rect_width});
+
+            /* shrink or remove segments covered by the new one */
+            for (size_t i = index + 1; i < skyline.size();) {
+                const int covered_end = skyline[i - 1].x + skyline[i - 1].width;
+                if (skyline[i].x >= covered_end) {
+                    break;
+                }
+                const int shrink = covered_end - skyline[i].x;
+                if (skyline[i].width <= shrink) {
+                    skyline.erase(skyline.begin() + i);
+                    continue;
+                }
+                skyline[i].x += shrink;
+                skyline[i].width -= shrink;
+                break;
+            }
+
+            /* merge neighboring segments of the same height */
+            for (size_t i = 0; i + 1 < skyline.size();) {
+                if (skyline[i].y == skyline[i + 1].y) {
+                    skyline[i].width += skyline[i + 1].width;
+                    skyline.erase(skyline.begin() + i + 1);
+                } else {
+                    ++i;
+                }
+            }
+        }
+    };
+} // namespace umfeld
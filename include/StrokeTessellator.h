@@ -0,0 +1,300 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "UmfeldConstants.h"
+
+namespace umfeld {
+    /**
+     * tessellates line strips with BEVEL, MITER or ROUND joins into triangles without going through
+     * libtess2. segment bodies share the inner intersection point of each join, so the resulting
+     * triangles do not overlap and translucent strokes blend correctly. the outer side of a join is
+     * filled with a wedge ( bevel triangle, miter tip or round fan ).
+     *
+     * this only works if the inner intersection of a join does not reach past the neighboring
+     * joins ( i.e short segments with sharp turns relative to the stroke weight ). in that case
+     * `tessellate()` returns `false` and the caller should fall back to `triangulate_line_strip()`.
+     *
+     * points, directions and join values are stored as struct-of-arrays in buffers that are reused
+     * between calls, so no allocations happen once the buffers have grown. the per-segment and
+     * per-join passes are branch-free loops over contiguous floats which compilers vectorize
+     * ( 4 lanes with SSE/NEON, 8 lanes with AVX ).
+     */
+    class StrokeTessellator {
+    public:
+        static bool supports(const int stroke_join_mode) {
+            return stroke_join_mode == BEVEL || stroke_join_mode == MITER || stroke_join_mode == ROUND;
+        }
+
+        void set_style(const float stroke_weight,
+                       const int   stroke_join_mode,
+                       const int   stroke_cap_mode,
+                       const float stroke_join_round_resolution,
+                       const float stroke_cap_round_resolution,
+                       const float stroke_join_miter_max_angle) {
+            half_width            = stroke_weight * 0.5f;
+            join_mode             = stroke_join_mode;
+            cap_mode              = stroke_cap_mode;
+            join_round_resolution = std::max(stroke_join_round_resolution, MIN_ROUND_RESOLUTION);
+            cap_round_resolution  = std::max(stroke_cap_round_resolution, MIN_ROUND_RESOLUTION);
+            miter_max_angle       = glm::radians(stroke_join_miter_max_angle);
+        }
+
+        /**
+         * @return upper bound of vertices written by `tessellate()` for a strip with `num_points`
+         */
+        size_t max_output_vertices(const size_t num_points) const {
+            const size_t round_join = 3 * static_cast<size_t>(std::ceil(PI / join_round_resolution));
+            const size_t round_cap  = 3 * static_cast<size_t>(std::ceil(PI / cap_round_resolution));
+            const size_t per_join   = std::max<size_t>(6, join_mode == ROUND ? round_join : 0);
+            const size_t per_cap    = std::max<size_t>(6, cap_mode == ROUND ? round_cap : 0);
+            return num_points * (6 + per_join) + 2 * per_cap;
+        }
+
+        /**
+         * tessellates `line_strip` and writes triangles into `triangles` ( which must hold at least
+         * `max_output_vertices(num_points)` vertices ).
+         * @return `false` if the strip cannot be tessellated without self-intersections. nothing is
+         *         written in that case.
+         */
+        bool tessellate(const glm::vec2* line_strip,
+                        const size_t     num_points,
+                        bool             close_shape,
+                        glm::vec2*       triangles,
+                        size_t&          num_triangle_vertices) {
+            num_triangle_vertices = 0;
+            if (half_width <= 0.0f) {
+                return true;
+            }
+
+            /* load points, skip consecutive duplicates */
+            px.resize(num_points + 1);
+            py.resize(num_points + 1);
+            size_t n = 0;
+            for (size_t i = 0; i < num_points; ++i) {
+                if (n == 0 || line_strip[i].x != px[n - 1] || line_strip[i].y != py[n - 1]) {
+                    px[n] = line_strip[i].x;
+                    py[n] = line_strip[i].y;
+                    n++;
+                }
+            }
+            if (n > 2 && px[n - 1] == px[0] && py[n - 1] == py[0]) {
+                n--; // NOTE closing point is implied
+            }
+            if (n < 2) {
+                return true;
+            }
+            close_shape             = close_shape && n > 2;
+            px[n]                   = px[0];
+            py[n]                   = py[0];
+            const size_t num_segs   = close_shape ? n : n - 1;
+            const float  half_width = this->half_width;
+
+            /* segment directions ( vectorized ) */
+            dx.resize(num_segs);
+            dy.resize(num_segs);
+            seg_length.resize(num_segs);
+            for (size_t j = 0; j < num_segs; ++j) {
+                const float ex = px[j + 1] - px[j];
+                const float ey = py[j + 1] - py[j];
+                const float l  = std::sqrt(ex * ex + ey * ey);
+                dx[j]          = ex / l;
+                dy[j]          = ey / l;
+                seg_length[j]  = l;
+            }
+
+            /* joins at points ( vectorized ). join `k` is between segment `k - 1` and `k` */
+            join_cross.resize(n + 1);
+            join_dot.resize(n + 1);
+            join_inset.resize(n + 1);
+            for (size_t k = 1; k < num_segs; ++k) {
+                const float cr = dx[k - 1] * dy[k] - dy[k - 1] * dx[k];
+                const float dt = dx[k - 1] * dx[k] + dy[k - 1] * dy[k];
+                join_cross[k]  = cr;
+                join_dot[k]    = dt;
+                join_inset[k]  = half_width * std::abs(cr) / std::max(1.0f + dt, EPSILON); // NOTE `half_width * tan(angle / 2)`
+            }
+            if (close_shape) {
+                const float cr = dx[num_segs - 1] * dy[0] - dy[num_segs - 1] * dx[0];
+                const float dt = dx[num_segs - 1] * dx[0] + dy[num_segs - 1] * dy[0];
+                join_cross[0]  = cr;
+                join_dot[0]    = dt;
+                join_inset[0]  = half_width * std::abs(cr) / std::max(1.0f + dt, EPSILON);
+            } else {
+                join_cross[0] = join_cross[n - 1] = 0.0f;
+                join_dot[0] = join_dot[n - 1] = 1.0f;
+                join_inset[0] = join_inset[n - 1] = 0.0f;
+            }
+            join_cross[n] = join_cross[0];
+            join_dot[n]   = join_dot[0];
+            join_inset[n] = join_inset[0];
+
+            /* inner intersections must stay within their segments */
+            bool self_intersecting = false;
+            for (size_t j = 0; j < num_segs; ++j) {
+                self_intersecting |= join_inset[j] + join_inset[j + 1] > seg_length[j];
+            }
+            if (self_intersecting) {
+                return false;
+            }
+
+            /* emit */
+            glm::vec2* out = triangles;
+            for (size_t j = 0; j < num_segs; ++j) {
+                const glm::vec2 normal{-dy[j], dx[j]};
+                glm::vec2       start_plus, start_minus, end_plus, end_minus;
+                join_edge(j, j, normal, start_plus, start_minus);
+                join_edge(j + 1, j, normal, end_plus, end_minus);
+                out = add_triangle(out, start_plus, end_plus, end_minus);
+                out = add_triangle(out, start_plus, end_minus, start_minus);
+                if (close_shape || j + 1 < num_segs) {
+                    out = add_join_wedge(out, j + 1, j, (j + 1) % num_segs);
+                }
+            }
+            if (!close_shape) {
+                out = add_cap(out, {px[0], py[0]}, {-dx[0], -dy[0]});
+                out = add_cap(out, {px[n - 1], py[n - 1]}, {dx[num_segs - 1], dy[num_segs - 1]});
+            }
+            num_triangle_vertices = static_cast<size_t>(out - triangles);
+            return true;
+        }
+
+        /**
+         * appends triangles to `triangles`. capacity of `triangles` is reused between calls.
+         */
+        bool tessellate(const std::vector<glm::vec2>& line_strip, const bool close_shape, std::vector<glm::vec2>& triangles) {
+            const size_t offset = triangles.size();
+            triangles.resize(offset + max_output_vertices(line_strip.size()));
+            size_t     num_triangle_vertices;
+            const bool result = tessellate(line_strip.data(), line_strip.size(), close_shape, triangles.data() + offset, num_triangle_vertices);
+            triangles.resize(offset + num_triangle_vertices);
+            return result;
+        }
+
+    private:
+        static constexpr float EPSILON              = 0.0001f;
+        static constexpr float MIN_ROUND_RESOLUTION = 0.01f;
+        float                  half_width{0.5f};
+        int                    join_mode{BEVEL};
+        int                    cap_mode{SQUARE};
+        float                  join_round_resolution{0.35f};
+        float                  cap_round_resolution{0.35f};
+        float                  miter_max_angle{2.84f};
+        std::vector<float>     px, py;
+        std::vector<float>     dx, dy, seg_length;
+        std::vector<float>     join_cross, join_dot, join_inset;
+
+        static glm::vec2* add_triangle(glm::vec2* out, const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+            out[0] = a;
+            out[1] = b;
+            out[2] = c;
+            return out + 3;
+        }
+
+        static glm::vec2* add_fan(glm::vec2* out, const glm::vec2& center, const glm::vec2& pivot, glm::vec2 from, const float angle, const float resolution) {
+            const int       num_steps = std::max(1, static_cast<int>(std::ceil(std::abs(angle) / resolution)));
+            const float     step      = angle / static_cast<float>(num_steps);
+            const glm::vec2 rotation{std::cos(step), std::sin(step)};
+            for (int i = 0; i < num_steps; ++i) {
+                const glm::vec2 to{from.x * rotation.x - from.y * rotation.y, from.x * rotation.y + from.y * rotation.x};
+                out  = add_triangle(out, pivot, center + from, center + to);
+                from = to;
+            }
+            return out;
+        }
+
+        /**
+         * computes the edge of segment `seg` at point `k`. the inner side uses the join intersection,
+         * the outer side the plain offset.
+         */
+        void join_edge(const size_t k, const size_t seg, const glm::vec2& normal, glm::vec2& plus, glm::vec2& minus) const {
+            const glm::vec2 p{px[k], py[k]};
+            const glm::vec2 offset = normal * half_width;
+            plus                   = p + offset;
+            minus                  = p - offset;
+            if (std::abs(join_cross[k]) < EPSILON) {
+                return;
+            }
+            const glm::vec2 inner = p - outer_side(k) * join_bisector(k, seg);
+            (outer_side(k) > 0.0f ? minus : plus) = inner;
+        }
+
+        float outer_side(const size_t k) const {
+            return join_cross[k] > 0.0f ? -1.0f : 1.0f;
+        }
+
+        /**
+         * @return `( n_prev + n_next ) * half_width / ( 1 + cos(angle) )` i.e the vector from the
+         *         join point to the miter tip
+         */
+        glm::vec2 join_bisector(const size_t k, const size_t seg) const {
+            const size_t    prev = k == seg ? (seg == 0 ? dx.size() - 1 : seg - 1) : seg;
+            const size_t    next = k == seg ? seg : (seg + 1) % dx.size();
+            const glm::vec2 n_sum{-dy[prev] - dy[next], dx[prev] + dx[next]};
+            return n_sum * (half_width / std::max(1.0f + join_dot[k], EPSILON));
+        }
+
+        glm::vec2* add_join_wedge(glm::vec2* out, const size_t k, const size_t seg_prev, const size_t seg_next) const {
+            if (std::abs(join_cross[k]) < EPSILON) {
+                return out;
+            }
+            const glm::vec2 p{px[k], py[k]};
+            const float     side     = outer_side(k);
+            const glm::vec2 bisector = join_bisector(k, seg_prev);
+            const glm::vec2 inner    = p - side * bisector;
+            const glm::vec2 a        = p + side * glm::vec2{-dy[seg_prev], dx[seg_prev]} * half_width;
+            const glm::vec2 b        = p + side * glm::vec2{-dy[seg_next], dx[seg_next]} * half_width;
+            const float     angle    = std::atan2(join_cross[k], join_dot[k]);
+            if (join_mode == ROUND) {
+                return add_fan(out, p, inner, a - p, angle, join_round_resolution);
+            }
+            if (join_mode == MITER && std::abs(angle) < miter_max_angle) {
+                const glm::vec2 tip = p + side * bisector;
+                out                 = add_triangle(out, inner, a, tip);
+                return add_triangle(out, inner, tip, b);
+            }
+            return add_triangle(out, inner, a, b);
+        }
+
+        /**
+         * @param direction points away from the line
+         */
+        glm::vec2* add_cap(glm::vec2* out, const glm::vec2& p, const glm::vec2& direction) const {
+            const glm::vec2 n{-direction.y * half_width, direction.x * half_width};
+            const glm::vec2 d = direction * half_width;
+            if (cap_mode == PROJECT) {
+                out = add_triangle(out, p + n, p - n, p - n + d);
+                return add_triangle(out, p + n, p - n + d, p + n + d);
+            }
+            if (cap_mode == POINTED) {
+                return add_triangle(out, p + n, p - n, p + d);
+            }
+            if (cap_mode == ROUND) {
+                return add_fan(out, p, p, n, -PI, cap_round_resolution); // NOTE rotates from `n` through `direction` to `-n`
+            }
+            return out; // NOTE SQUARE
+        }
+    };
+} // namespace umfeld
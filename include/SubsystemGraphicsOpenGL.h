@@ -71,16 +71,21 @@ namespace umfeld {
         /* window */
 
         SDL_WindowFlags flags = SDL_WINDOW_OPENGL;
-        window                = SDL_CreateWindow(get_window_title().c_str(),
-                                                 static_cast<int>(umfeld::width),
-                                                 static_cast<int>(umfeld::height),
-                                                 get_SDL_WindowFlags(flags));
+        if (headless) {
+            flags |= SDL_WINDOW_HIDDEN;
+        }
+        window = SDL_CreateWindow(get_window_title().c_str(),
+                                  static_cast<int>(umfeld::width),
+                                  static_cast<int>(umfeld::height),
+                                  get_SDL_WindowFlags(flags));
         if (window == nullptr) {
             error("Couldn't create window: ", SDL_GetError());
             return false;
         }
 
-        center_display(window);
+        if (!headless) {
+            center_display(window);
+        }
 
         /* create opengl context */
 
@@ -96,12 +101,20 @@ namespace umfeld {
 
         /* display window */
 
-        SDL_ShowWindow(window);
+        if (!headless) {
+            SDL_ShowWindow(window);
+        }
 
         /* initialize GLEW */
 
         glewExperimental            = GL_TRUE;
         const GLenum glewInitResult = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+        // NOTE GLEW built for GLX reports this for EGL contexts ( e.g headless ) but loads the functions anyway
+        if (headless && glewInitResult == GLEW_ERROR_NO_GLX_DISPLAY) {
+            warning("GLEW reports no GLX display. continuing with EGL context.");
+        } else
+#endif
         if (GLEW_OK != glewInitResult) {
             error("problem initializing GLEW: ", glewGetErrorString(glewInitResult));
             SDL_GL_DestroyContext(gl_context);
@@ -168,6 +181,11 @@ namespace umfeld {
 
         g->endDraw();
 
+        if (headless) {
+            glFlush(); // NOTE nothing is presented, frames stay in the offscreen framebuffer
+            return;
+        }
+
         if (g->render_to_offscreen && g->framebuffer.id > 0) {
             g->render_framebuffer_to_screen(blit_framebuffer_object_to_screenbuffer);
         }
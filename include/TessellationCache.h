@@ -0,0 +1,186 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "Vertex.h"
+
+namespace umfeld {
+    /**
+     * caches the result of polygon triangulations keyed by the outline positions and the
+     * triangulation strategy. results are stored independently of vertex attributes: each resulting
+     * vertex references the outline vertex it was created from ( or none if the triangulator created
+     * a new vertex e.g at a self-intersection ). this way a static outline with changing fill color
+     * still hits the cache.
+     *
+     * an outline is only stored once it is triangulated a second time within `max_unused_frames`
+     * frames, so animated outlines that never repeat do not fill the cache. entries that have not been
+     * used for `max_unused_frames` frames are evicted in `next_frame()`.
+     */
+    class TessellationCache {
+    public:
+        static constexpr int32_t NO_SOURCE_VERTEX = -1;
+
+        struct TessellatedVertex {
+            glm::vec3 position;
+            int32_t   source_index; // NOTE index into outline or `NO_SOURCE_VERTEX`
+        };
+
+        using Triangles = std::vector<TessellatedVertex>;
+
+        struct Entry {
+            std::vector<glm::vec3> outline;
+            Triangles              triangles;
+            uint64_t               last_used_frame{0};
+        };
+
+        size_t   max_entries{4096};
+        uint64_t max_unused_frames{60};
+
+        static uint64_t hash(const std::vector<Vertex>& outline, const int strategy) {
+            // NOTE FNV-1a over strategy and position bits
+            uint64_t   key = 14695981039346656037ull;
+            const auto mix = [&key](const uint32_t value) {
+                key ^= value;
+                key *= 1099511628211ull;
+            };
+            mix(static_cast<uint32_t>(strategy));
+            for (const auto& v: outline) {
+                uint32_t bits[3];
+                std::memcpy(bits, &v.position, sizeof(bits));
+                mix(bits[0]);
+                mix(bits[1]);
+                mix(bits[2]);
+            }
+            return key;
+        }
+
+        /**
+         * @return triangulation of `outline` or `nullptr` if not in cache
+         */
+        const Triangles* find(const uint64_t key, const std::vector<Vertex>& outline) {
+            const auto it = entries.find(key);
+            if (it == entries.end() || !same_outline(it->second.outline, outline)) {
+                misses++;
+                return nullptr;
+            }
+            hits++;
+            it->second.last_used_frame = frame;
+            return &it->second.triangles;
+        }
+
+        /**
+         * stores the triangulation `triangles` created from `outline` if the outline was already
+         * triangulated recently ( see `max_unused_frames` ).
+         */
+        void insert(const uint64_t key, const std::vector<Vertex>& outline, const Triangles& triangles) {
+            const auto candidate = candidates.find(key);
+            if (candidate == candidates.end()) {
+                if (candidates.size() >= max_entries) {
+                    evict(candidates, 0);
+                }
+                candidates[key] = frame;
+                return;
+            }
+            candidates.erase(candidate);
+            if (entries.size() >= max_entries) {
+                evict(entries, 0); // NOTE only keep entries used in the current frame
+            }
+            Entry& entry = entries[key];
+            entry.outline.clear();
+            entry.outline.reserve(outline.size());
+            for (const auto& v: outline) {
+                entry.outline.emplace_back(v.position);
+            }
+            entry.triangles       = triangles;
+            entry.last_used_frame = frame;
+        }
+
+        /**
+         * reconstructs triangle vertices with attributes from `outline`. vertices without source take
+         * the attributes of the first outline vertex. cached and uncached triangulations are resolved
+         * with this function so that both produce the same vertices.
+         */
+        static void resolve(const Triangles& triangles, const std::vector<Vertex>& outline, std::vector<Vertex>& triangle_vertices) {
+            triangle_vertices.clear();
+            triangle_vertices.reserve(triangles.size());
+            for (const auto& t: triangles) {
+                if (t.source_index != NO_SOURCE_VERTEX) {
+                    triangle_vertices.push_back(outline[t.source_index]);
+                } else {
+                    triangle_vertices.push_back(outline[0]);
+                    triangle_vertices.back().position = glm::vec4(t.position, outline[0].position.w);
+                }
+            }
+        }
+
+        void next_frame() {
+            frame++;
+            evict(entries, max_unused_frames);
+            evict(candidates, max_unused_frames);
+        }
+
+        void clear() {
+            entries.clear();
+            candidates.clear();
+        }
+
+        size_t   size() const { return entries.size(); }
+        uint64_t num_hits() const { return hits; }
+        uint64_t num_misses() const { return misses; }
+
+    private:
+        std::unordered_map<uint64_t, Entry>    entries;
+        std::unordered_map<uint64_t, uint64_t> candidates; // NOTE keys triangulated once and the frame they were seen in
+        uint64_t                               frame{0};
+        uint64_t                               hits{0};
+        uint64_t                               misses{0};
+
+        static uint64_t last_used(const Entry& entry) { return entry.last_used_frame; }
+        static uint64_t last_used(const uint64_t candidate_frame) { return candidate_frame; }
+
+        template<typename MAP>
+        void evict(MAP& map, const uint64_t max_age) {
+            for (auto it = map.begin(); it != map.end();) {
+                if (frame - last_used(it->second) > max_age) {
+                    it = map.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        static bool same_outline(const std::vector<glm::vec3>& cached, const std::vector<Vertex>& outline) {
+            if (cached.size() != outline.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < cached.size(); ++i) {
+                if (cached[i] != glm::vec3(outline[i].position)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+} // namespace umfeld
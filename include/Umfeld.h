@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -36,6 +37,7 @@ namespace umfeld {
 
     /* --- audio  --- */
     inline bool enable_audio           = false;
+    inline bool run_audio_in_thread    = false; // NOTE `audioEvent()` is called from the device callback on the audio thread instead of from the main loop
     inline int  audio_unique_device_id = 0x0010;
     // inline int        audio_format       = 0; // TODO currently only supporting F32
 
@@ -50,6 +52,8 @@ namespace umfeld {
     inline bool retina_support   = true;
     inline bool vsync            = false;
     inline bool render_to_buffer = false;
+    inline bool headless         = false; // NOTE renders into the offscreen framebuffer without window or display ( OpenGL 3.3 only )
+    inline bool fixed_timestep   = false; // NOTE frames are drawn back to back, `frameRate` and `millis()` advance exactly one frame per frame
 
     /* --- libraries + events --- */
     inline bool enable_libraries = true;
@@ -104,6 +108,7 @@ namespace umfeld {
     inline SubsystemAudio*         subsystem_audio      = nullptr;
     inline Subsystem*              subsystem_libraries  = nullptr;
     inline Subsystem*              subsystem_hid_events = nullptr;
+    inline int64_t                 fixed_timestep_ns    = 0; // NOTE duration of all frames drawn in `fixed_timestep` mode
 
     // TODO move these functions to `UmfeldFunctions`
 
@@ -145,7 +145,23 @@ namespace umfeld {
         ENABLE_SMOOTH_LINES = 0xA0,
         DISABLE_SMOOTH_LINES,
         ENABLE_DEPTH_TEST,
-        DISABLE_DEPTH_TEST
+        DISABLE_DEPTH_TEST,
+        ENABLE_PACKED_VERTICES, // NOTE stream vertices in compact format ( see `PackedVertex` )
+        DISABLE_PACKED_VERTICES,
+        ENABLE_ORDER_INDEPENDENT_TRANSPARENCY, // NOTE translucent fills are composited at `endDraw()`
+        DISABLE_ORDER_INDEPENDENT_TRANSPARENCY,
+        ENABLE_DEPTH_SORT_TRANSLUCENT, // NOTE translucent fills are sorted back-to-front before submission
+        DISABLE_DEPTH_SORT_TRANSLUCENT,
+        ENABLE_TESSELLATION_CACHE, // NOTE triangulated `POLYGON` shapes are cached by outline ( default )
+        DISABLE_TESSELLATION_CACHE,
+        ENABLE_SIGNED_DISTANCE_FIELD_FONTS, // NOTE fonts loaded afterwards use signed distance field atlases
+        DISABLE_SIGNED_DISTANCE_FIELD_FONTS
+    };
+    enum InstanceShape {
+        RECT = 0xC0,
+        ELLIPSE,
+        BOX,
+        SPHERE
     };
     enum Renderer {
         OPENGL_3_3 = 0xB0,       // core profile
@@ -157,4 +173,6 @@ namespace umfeld {
     const std::string SHADER_UNIFORM_MODEL_MATRIX      = "uModelMatrix";
     const std::string SHADER_UNIFORM_VIEW_MATRIX       = "uViewMatrix";
     const std::string SHADER_UNIFORM_PROJECTION_MATRIX = "uProjection";
+    const std::string SHADER_UNIFORM_BLOCK_MATRICES    = "uMatrices"; // NOTE std140 block with `uProjection` and `uViewMatrix`
+    static constexpr int SHADER_UNIFORM_BLOCK_MATRICES_BINDING = 0;
 } // namespace umfeld
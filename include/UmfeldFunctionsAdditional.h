@@ -74,6 +74,7 @@ namespace umfeld {
     void                     unregister_library(const LibraryListener* listener); /* implemented in subsystems */
     void                     handle_events_in_loop(bool events_in_loop);          /* implemented in subsystems */
     std::vector<Vertex>      loadOBJ(const std::string& filename, bool material = true);
+    bool                     loadOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool material = true);
     Sampler*                 loadSample(const std::string& filename);
     PAudio*                  createAudio(const AudioUnitInfo* device_info);
 
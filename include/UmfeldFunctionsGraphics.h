@@ -71,6 +71,7 @@ namespace umfeld {
     void     strokeCap(int cap);
     void     vertex(float x, float y, float z = 0.0);
     void     vertex(float x, float y, float z, float u, float v);
+    void     polygons(const std::vector<std::vector<glm::vec3>>& outlines, bool close_shape = true);
     PFont*   loadFont(const std::string& file, float size); // @development maybe use smart pointers here
     void     textFont(PFont* font);
     void     textSize(float size);
@@ -102,6 +103,11 @@ namespace umfeld {
     void     sphere(float size);
     void     sphere(float width, float height, float depth);
     void     mesh(VertexBuffer* mesh_shape = nullptr);
+    void     beginInstances();
+    void     instance();
+    void     instance(const glm::mat4& transform, const glm::vec4& color);
+    void     endInstances(VertexBuffer* mesh_shape);
+    void     endInstances(int instance_shape);
     void     shader(PShader* shader = nullptr);
     PShader* loadShader(const std::string& vertex_code, const std::string& fragment_code, const std::string& geometry_code = "");
     struct ShaderSource;
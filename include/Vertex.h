@@ -19,7 +19,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtx/type_aligned.hpp>
 
 namespace umfeld {
@@ -59,4 +61,41 @@ namespace umfeld {
         Vertex()
             : Vertex(glm::vec3(DEFAULT_POSITION)) {}
     };
-} // namespace umfeld
\ No newline at end of file
+
+    /**
+     * compact vertex layout ( 24 bytes instead of 80 bytes ) for streaming geometry to the GPU:
+     *
+     * - position  :: 3× float
+     * - normal    :: signed normalized 10-10-10-2 ( `GL_INT_2_10_10_10_REV` )
+     * - color     :: unsigned normalized 4× 8-bit ( `GL_UNSIGNED_BYTE` ) i.e colors are clamped to [0,1]
+     * - tex_coord :: 2× half float ( `GL_HALF_FLOAT` ) i.e repeating texture coordinates outside [0,1] are fine
+     *
+     * NOTE position `w` is dropped ( and restored as 1.0 by the vertex attribute fetch ). components are
+     *      packed with the first component in the lowest bits ( i.e assumes a little-endian host ).
+     */
+    struct PackedVertex {
+        glm::vec3 position;
+        uint32_t  normal;
+        uint32_t  color;
+        uint32_t  tex_coord;
+
+        PackedVertex() : PackedVertex(Vertex()) {}
+
+        explicit PackedVertex(const Vertex& vertex)
+            : position(vertex.position),
+              normal(glm::packSnorm3x10_1x2(glm::clamp(glm::vec4(vertex.normal), -1.0f, 1.0f))),
+              color(glm::packUnorm4x8(glm::vec4(vertex.color))),
+              tex_coord(glm::packHalf2x16(vertex.tex_coord)) {}
+    };
+
+    static_assert(sizeof(PackedVertex) == 24, "PackedVertex is expected to be tightly packed");
+
+    /**
+     * per-instance attributes for instanced drawing ( see `beginInstances()` ). the model matrix
+     * occupies four consecutive attribute locations.
+     */
+    struct InstanceData {
+        glm::mat4 model_matrix;
+        glm::vec4 color;
+    };
+} // namespace umfeld
@@ -30,29 +30,48 @@ namespace umfeld {
     public:
         ~VertexBuffer();
 
-        void                 add_vertex(const Vertex& vertex);
-        void                 add_vertices(const std::vector<Vertex>& new_vertices);
-        void                 draw();
-        void                 clear();
-        void                 update();
-        std::vector<Vertex>& vertices_data() { return _vertices; }
-        void                 init();
-        void                 set_shape(const int shape) { this->shape = shape; }
-        int                  get_shape() const { return shape; }
+        void                   add_vertex(const Vertex& vertex);
+        void                   add_vertices(const std::vector<Vertex>& new_vertices);
+        void                   add_index(uint32_t index);
+        void                   add_indices(const std::vector<uint32_t>& new_indices);
+        void                   set_vertex(size_t index, const Vertex& vertex);
+        void                   mark_dirty(size_t first_vertex, size_t num_vertices);
+        void                   draw();
+        void                   draw_instanced(GLuint instance_vbo, int num_instances);
+        void                   clear();
+        void                   update();
+        std::vector<Vertex>&   vertices_data() { return _vertices; }
+        std::vector<uint32_t>& indices_data() { return _indices; }
+        bool                   indexed() const { return !_indices.empty(); } // NOTE draws with `glDrawElements` if indices are present
+        void                   init();
+        void                   set_shape(const int shape) { this->shape = shape; }
+        int                    get_shape() const { return shape; }
 
     private:
-        const int           VBO_BUFFER_CHUNK_SIZE_BYTES = 1024 * 16 * sizeof(Vertex);
-        std::vector<Vertex> _vertices;
-        GLuint              vbo = 0, vao = 0;
-        bool                vao_supported      = false;
-        bool                initial_upload     = false;
-        bool                buffer_initialized = false;
-        int                 server_buffer_size{0};
-        int                 shape = TRIANGLES;
-        bool                dirty = false;
+        struct DirtyRange {
+            size_t begin;
+            size_t end; // NOTE exclusive
+        };
+        static constexpr size_t VBO_BUFFER_CHUNK_SIZE_VERTICES = 1024 * 16;
+        static constexpr size_t MAX_DIRTY_RANGES               = 32;
+        std::vector<Vertex>     _vertices;
+        std::vector<uint32_t>   _indices;
+        std::vector<uint16_t>   _indices_16; // NOTE indices are uploaded as 16-bit if all vertices can be addressed
+        std::vector<DirtyRange> dirty_ranges;
+        GLuint                  vbo = 0, vao = 0, ebo = 0;
+        GLenum                  index_type         = GL_UNSIGNED_INT;
+        bool                    vao_supported      = false;
+        bool                    initial_upload     = false;
+        bool                    buffer_initialized = false;
+        size_t                  server_buffer_size{0}; // NOTE in vertices
+        int                     shape = TRIANGLES;
+        bool                    dirty = false;
+        bool                    indices_dirty = false;
+        GLuint                  instance_vbo_attached = 0;
 
-        void resize_buffer();
+        bool resize_buffer();
         void upload();
+        void upload_indices();
         void checkVAOSupport();
     };
 } // namespace umfeld
\ No newline at end of file
@@ -0,0 +1,145 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace umfeld {
+    /**
+     * small pool of persistent worker threads to distribute independent tasks. `parallel_for` blocks
+     * until all tasks are done, the calling thread works on tasks as well. tasks are handed out via an
+     * atomic counter, so tasks of different cost are balanced between threads.
+     *
+     * NOTE `parallel_for` is meant to be called from a single thread ( usually the draw thread ) at a
+     *      time.
+     */
+    class WorkerPool {
+    public:
+        explicit WorkerPool(const unsigned num_threads = 0) {
+            const unsigned num_workers = (num_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : num_threads) - 1;
+            workers.reserve(num_workers);
+            for (unsigned i = 0; i < num_workers; ++i) {
+                workers.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard lock(mutex);
+                running = false;
+            }
+            job_available.notify_all();
+            for (auto& worker: workers) {
+                worker.join();
+            }
+        }
+
+        WorkerPool(const WorkerPool&)            = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        size_t num_threads() const { return workers.size() + 1; }
+
+        /**
+         * calls `task(i)` for every `i` in `[0, num_tasks)` distributed over all threads of the pool
+         * and returns once all tasks are done.
+         */
+        void parallel_for(const size_t num_tasks, const std::function<void(size_t)>& task) {
+            if (num_tasks == 0) {
+                return;
+            }
+            if (workers.empty() || num_tasks == 1) {
+                for (size_t i = 0; i < num_tasks; ++i) {
+                    task(i);
+                }
+                return;
+            }
+            {
+                std::lock_guard lock(mutex);
+                job_task         = &task;
+                job_num_tasks    = num_tasks;
+                job_next_task    = 0;
+                job_active_count = workers.size();
+                job_generation++;
+            }
+            job_available.notify_all();
+            run_tasks(task, num_tasks);
+            std::unique_lock lock(mutex);
+            job_finished.wait(lock, [this] { return job_active_count == 0; });
+            job_task = nullptr;
+        }
+
+    private:
+        std::vector<std::thread>           workers;
+        std::mutex                         mutex;
+        std::condition_variable            job_available;
+        std::condition_variable            job_finished;
+        const std::function<void(size_t)>* job_task{nullptr};
+        size_t                             job_num_tasks{0};
+        std::atomic<size_t>                job_next_task{0};
+        size_t                             job_active_count{0};
+        uint64_t                           job_generation{0};
+        bool                               running{true};
+
+        void run_tasks(const std::function<void(size_t)>& task, const size_t num_tasks) {
+            for (size_t i = job_next_task.fetch_add(1); i < num_tasks; i = job_next_task.fetch_add(1)) {
+                task(i);
+            }
+        }
+
+        void worker_loop() {
+            uint64_t seen_generation = 0;
+            while (true) {
+                const std::function<void(size_t)>* task;
+                size_t                             num_tasks;
+                {
+                    std::unique_lock lock(mutex);
+                    job_available.wait(lock, [&] { return !running || job_generation != seen_generation; });
+                    if (!running) {
+                        return;
+                    }
+                    seen_generation = job_generation;
+                    task            = job_task;
+                    num_tasks       = job_num_tasks;
+                }
+                run_tasks(*task, num_tasks);
+                {
+                    std::lock_guard lock(mutex);
+                    job_active_count--;
+                }
+                job_finished.notify_one();
+            }
+        }
+    };
+
+    /**
+     * worker pool shared by all subsystems. threads are created on first use.
+     */
+    inline WorkerPool& shared_worker_pool() {
+        static WorkerPool pool;
+        return pool;
+    }
+} // namespace umfeld
@@ -82,17 +82,25 @@ namespace umfeld {
         void process(float*         signal_buffer_left,
                      float*         signal_buffer_right,
                      const uint32_t buffer_length) {
-            for (uint32_t i = 0; i < buffer_length; i++) {
-                step();
-                signal_buffer_left[i] *= fAmp;
-                signal_buffer_right[i] *= fAmp;
+            uint32_t i = 0;
+            while (i < buffer_length) {
+                float          amp_start;
+                float          amp_increment;
+                const uint32_t length = next_segment(buffer_length - i, amp_start, amp_increment);
+                AudioUtilities::mult_ramp(signal_buffer_left + i, amp_start, amp_increment, length);
+                AudioUtilities::mult_ramp(signal_buffer_right + i, amp_start, amp_increment, length);
+                i += length;
             }
         }
 
         void process(float* signal_buffer, const uint32_t buffer_length) {
-            for (uint32_t i = 0; i < buffer_length; i++) {
-                step();
-                signal_buffer[i] *= fAmp;
+            uint32_t i = 0;
+            while (i < buffer_length) {
+                float          amp_start;
+                float          amp_increment;
+                const uint32_t length = next_segment(buffer_length - i, amp_start, amp_increment);
+                AudioUtilities::mult_ramp(signal_buffer + i, amp_start, amp_increment, length);
+                i += length;
             }
         }
 
@@ -147,6 +155,13 @@ namespace umfeld {
             return fState == ENVELOPE_STATE::IDLE;
         }
 
+        /**
+         * @return current amplitude of the envelope
+         */
+        float current() const {
+            return fAmp;
+        }
+
     private:
         enum class ENVELOPE_STATE {
             IDLE,
@@ -199,6 +214,43 @@ namespace umfeld {
             fState = pState;
         }
 
+        /**
+         * advances the envelope by up to `remaining` samples in which the amplitude follows
+         * `amp_start + amp_increment * (i + 1)` without changing state. the sample on which the state
+         * changes is handled by `step()` as a segment of length 1.
+         */
+        uint32_t next_segment(const uint32_t remaining, float& amp_start, float& amp_increment) {
+            amp_start     = fAmp;
+            amp_increment = 0.0f;
+            float target;
+            switch (fState) {
+                case ENVELOPE_STATE::IDLE:
+                case ENVELOPE_STATE::SUSTAIN:
+                    return remaining;
+                case ENVELOPE_STATE::ATTACK:
+                    target = 1.0f;
+                    break;
+                case ENVELOPE_STATE::DECAY:
+                    target = fSustain;
+                    break;
+                default:
+                    target = 0.0f;
+                    break;
+            }
+            const float steps_to_target = fDelta != 0.0f ? (target - fAmp) / fDelta : 0.0f;
+            if (steps_to_target >= 2.0f) {
+                // NOTE stay one step away from the target so that rounding never skips a state change
+                const float    safe_steps = steps_to_target - 1.0f;
+                const uint32_t length     = safe_steps >= static_cast<float>(remaining) ? remaining : static_cast<uint32_t>(safe_steps);
+                amp_increment             = fDelta;
+                fAmp += fDelta * static_cast<float>(length);
+                return length;
+            }
+            step();
+            amp_start = fAmp;
+            return 1;
+        }
+
         void step() {
             switch (fState) {
                 case ENVELOPE_STATE::IDLE:
@@ -0,0 +1,151 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "SPSCQueue.h"
+
+namespace umfeld {
+    enum AudioEventType : uint8_t {
+        AUDIO_EVENT_PARAMETER = 0,
+        AUDIO_EVENT_NOTE_ON,
+        AUDIO_EVENT_NOTE_OFF,
+    };
+
+    /**
+     * parameter change or note event scheduled for a sample frame. `target` identifies the receiver
+     * e.g a voice or an oscillator, `parameter` is either a user defined parameter id or the note.
+     */
+    struct AudioEvent {
+        uint64_t       frame{0}; // NOTE absolute sample frame, `AUDIO_EVENT_IMMEDIATELY` applies it at the beginning of the next block
+        AudioEventType type{AUDIO_EVENT_PARAMETER};
+        uint16_t       target{0};
+        uint16_t       parameter{0};
+        float          value{0.0f}; // NOTE parameter value or velocity
+    };
+
+    static constexpr uint64_t AUDIO_EVENT_IMMEDIATELY = 0;
+
+    /**
+     * passes timestamped events from the draw thread to the audio thread without locks and applies
+     * them sample-accurately: the audio block is split at the frame of each event, so an event
+     * scheduled for frame `n` takes effect exactly at sample `n`.
+     *
+     * draw thread ( single producer ):
+     *
+     * <code>
+     * events.parameter(OSC_FREQUENCY, 0, 440.0f);
+     * events.note_on(VOICE_1, 60, 0.8f, events.current_frame() + audio_sample_rate / 10);
+     * </code>
+     *
+     * audio thread ( single consumer ) e.g in `audioEvent()`:
+     *
+     * <code>
+     * events.process(audio_buffer_size,
+     *     [&](const AudioEvent& e) {
+     *         if (e.target == OSC_FREQUENCY) { oscillator.set_frequency(e.value); }
+     *         if (e.type == AUDIO_EVENT_NOTE_ON) { adsr.start(); }
+     *     },
+     *     [&](const uint32_t offset, const uint32_t length) {
+     *         oscillator.process(audio_output_buffer + offset, length);
+     *     });
+     * </code>
+     *
+     * events must be pushed in chronological order. events scheduled in the past are applied at the
+     * beginning of the next block.
+     */
+    template<size_t CAPACITY = 1024>
+    class AudioEventQueue {
+    public:
+        /* --- producer --- */
+
+        /**
+         * @return false if the queue is full and the event was dropped
+         */
+        bool push(const AudioEvent& event) {
+            return queue.push(event);
+        }
+
+        bool parameter(const uint16_t target, const uint16_t parameter, const float value, const uint64_t frame = AUDIO_EVENT_IMMEDIATELY) {
+            return queue.push({frame, AUDIO_EVENT_PARAMETER, target, parameter, value});
+        }
+
+        bool note_on(const uint16_t target, const uint8_t note, const float velocity, const uint64_t frame = AUDIO_EVENT_IMMEDIATELY) {
+            return queue.push({frame, AUDIO_EVENT_NOTE_ON, target, note, velocity});
+        }
+
+        bool note_off(const uint16_t target, const uint8_t note, const uint64_t frame = AUDIO_EVENT_IMMEDIATELY) {
+            return queue.push({frame, AUDIO_EVENT_NOTE_OFF, target, note, 0.0f});
+        }
+
+        /**
+         * @return first sample frame of the next audio block. use it as a base to schedule events
+         *         relative to the audio clock.
+         */
+        uint64_t current_frame() const {
+            return frame_position.load(std::memory_order_acquire);
+        }
+
+        /* --- consumer --- */
+
+        /**
+         * processes one audio block of `num_frames` frames. calls `render(offset, length)` for every
+         * section of the block between two events and `handle_event(event)` for every event due in
+         * this block, in chronological order. events due in a later block remain queued.
+         */
+        template<typename EventHandler, typename RenderFunction>
+        void process(const uint32_t num_frames, EventHandler&& handle_event, RenderFunction&& render) {
+            const uint64_t block_start = frame_position.load(std::memory_order_relaxed);
+            uint32_t       offset      = 0;
+            while (true) {
+                const AudioEvent* event        = queue.front();
+                uint32_t          event_offset = num_frames;
+                if (event != nullptr && event->frame < block_start + num_frames) {
+                    event_offset = event->frame > block_start + offset ? static_cast<uint32_t>(event->frame - block_start) : offset;
+                }
+                if (event_offset > offset) {
+                    render(offset, event_offset - offset);
+                    offset = event_offset;
+                }
+                if (event == nullptr || event_offset >= num_frames) {
+                    break;
+                }
+                handle_event(*event);
+                queue.pop();
+            }
+            frame_position.store(block_start + num_frames, std::memory_order_release);
+        }
+
+        /**
+         * applies all events due in the next `num_frames` frames at once without splitting the block
+         * e.g for control rate parameters.
+         */
+        template<typename EventHandler>
+        void process(const uint32_t num_frames, EventHandler&& handle_event) {
+            process(num_frames, handle_event, [](uint32_t, uint32_t) {});
+        }
+
+    private:
+        SPSCQueue<AudioEvent, CAPACITY> queue;
+        std::atomic<uint64_t>           frame_position{0};
+    };
+} // namespace umfeld
@@ -0,0 +1,488 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "AudioUtilities.h"
+
+namespace umfeld {
+    /**
+     * uniform interface for all nodes of an `AudioGraph`. a node reads `num_inputs()` input channels
+     * and writes `num_outputs()` output channels of `num_frames` samples each. inputs connected to
+     * more than one output are summed by the graph, unconnected inputs are silent.
+     */
+    class AudioNode {
+    public:
+        AudioNode(const uint32_t num_inputs, const uint32_t num_outputs) : input_channels(num_inputs),
+                                                                          output_channels(num_outputs) {}
+        virtual ~AudioNode() = default;
+
+        AudioNode(const AudioNode&)            = delete;
+        AudioNode& operator=(const AudioNode&) = delete;
+
+        virtual void process(const float* const* inputs, float* const* outputs, uint32_t num_frames) = 0;
+
+        uint32_t num_inputs() const { return input_channels; }
+        uint32_t num_outputs() const { return output_channels; }
+
+        /**
+         * @return time spent in `process` per block in microseconds ( averaged over recent blocks ).
+         *         may be queried from any thread.
+         */
+        float cpu_time() const { return cpu_time_us.load(std::memory_order_relaxed); }
+
+    private:
+        friend class AudioGraph;
+        const uint32_t     input_channels;
+        const uint32_t     output_channels;
+        std::atomic<float> cpu_time_us{0.0f};
+    };
+
+    /**
+     * wraps a mono processor with `process(float*, uint32_t)` e.g `Wavetable`, `Sampler`, `Filter`,
+     * `LowPassFilter` or `ADSR`. the input is copied to the output and processed in place, so
+     * generators simply overwrite it.
+     *
+     * <code>
+     * auto* oscillator = graph.add<ProcessorNode<Wavetable>>(512, audio_sample_rate);
+     * oscillator->processor.set_frequency(220);
+     * </code>
+     */
+    template<class PROCESSOR>
+    class ProcessorNode : public AudioNode {
+    public:
+        PROCESSOR processor;
+
+        template<typename... Args>
+        explicit ProcessorNode(Args&&... args) : AudioNode(1, 1), processor(std::forward<Args>(args)...) {}
+
+        void process(const float* const* inputs, float* const* outputs, const uint32_t num_frames) override {
+            std::copy_n(inputs[0], num_frames, outputs[0]);
+            processor.process(outputs[0], num_frames);
+        }
+    };
+
+    /**
+     * wraps a stereo processor with `process(float*, float*, uint32_t)` e.g `Reverb` or `ADSR`
+     */
+    template<class PROCESSOR>
+    class StereoProcessorNode : public AudioNode {
+    public:
+        PROCESSOR processor;
+
+        template<typename... Args>
+        explicit StereoProcessorNode(Args&&... args) : AudioNode(2, 2), processor(std::forward<Args>(args)...) {}
+
+        void process(const float* const* inputs, float* const* outputs, const uint32_t num_frames) override {
+            std::copy_n(inputs[0], num_frames, outputs[0]);
+            std::copy_n(inputs[1], num_frames, outputs[1]);
+            processor.process(outputs[0], outputs[1], num_frames);
+        }
+    };
+
+    /**
+     * node calling a function e.g to read `audio_input_buffer` into the graph or for custom DSP
+     */
+    class FunctionNode : public AudioNode {
+    public:
+        using Function = std::function<void(const float* const* inputs, float* const* outputs, uint32_t num_frames)>;
+
+        FunctionNode(const uint32_t num_inputs, const uint32_t num_outputs, Function function) : AudioNode(num_inputs, num_outputs),
+                                                                                                 function(std::move(function)) {}
+
+        void process(const float* const* inputs, float* const* outputs, const uint32_t num_frames) override {
+            function(inputs, outputs, num_frames);
+        }
+
+    private:
+        Function function;
+    };
+
+    /**
+     * runs a graph of `AudioNode`s once per audio block. nodes whose inputs are ready are processed in
+     * parallel by the calling thread ( usually the audio thread ) and a fixed set of worker threads,
+     * so independent branches ( e.g a reverb and 32 spatialisation channels ) use several cores.
+     *
+     * scheduling within a block is lock-free: every node has an atomic counter of unfinished inputs
+     * and is pushed to a ready queue by the thread that finishes its last input. the calling thread
+     * never blocks, it processes nodes itself until all are done. workers spin briefly after each block
+     * and then sleep, a worker that oversleeps the start of a block merely does not help with it.
+     *
+     * <code>
+     * AudioGraph graph{audio_buffer_size, 4};
+     * auto* oscillator = graph.add<ProcessorNode<Wavetable>>(512, audio_sample_rate);
+     * auto* filter     = graph.add<ProcessorNode<LowPassFilter>>(audio_sample_rate);
+     * graph.connect(oscillator, 0, filter, 0);
+     * graph.compile();
+     *
+     * void audioEvent() {
+     *     graph.process(audio_buffer_size);
+     *     graph.write_interleaved(filter, audio_output_buffer, audio_output_channels, audio_buffer_size);
+     * }
+     * </code>
+     *
+     * nodes and connections are changed on the draw thread while the graph is not processed ( e.g
+     * before audio is started ). `compile` must be called after each change and allocates all buffers.
+     */
+    class AudioGraph {
+    public:
+        /**
+         * @param max_block_size largest number of frames passed to `process`
+         * @param num_threads    number of threads processing nodes including the calling thread
+         */
+        explicit AudioGraph(const uint32_t max_block_size, const unsigned num_threads = 1) : max_block_size(std::max(max_block_size, 1u)),
+                                                                                            silence(this->max_block_size, 0.0f) {
+            for (unsigned i = 1; i < num_threads; ++i) {
+                workers.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        ~AudioGraph() {
+            {
+                std::lock_guard lock(worker_mutex);
+                running = false;
+            }
+            worker_wakeup.notify_all();
+            for (auto& worker: workers) {
+                worker.join();
+            }
+        }
+
+        AudioGraph(const AudioGraph&)            = delete;
+        AudioGraph& operator=(const AudioGraph&) = delete;
+
+        unsigned num_threads() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+        template<class NODE, typename... Args>
+        NODE* add(Args&&... args) {
+            auto  node     = std::make_unique<NODE>(std::forward<Args>(args)...);
+            NODE* node_ptr = node.get();
+            nodes.push_back(std::move(node));
+            compiled = false;
+            return node_ptr;
+        }
+
+        /**
+         * connects an output channel of `source` to an input channel of `destination`
+         * @return false if a node is not part of the graph or a channel is out of range
+         */
+        bool connect(AudioNode* source, const uint32_t source_channel, AudioNode* destination, const uint32_t destination_channel) {
+            if (source == destination ||
+                !contains(source) || !contains(destination) ||
+                source_channel >= source->num_outputs() ||
+                destination_channel >= destination->num_inputs()) {
+                return false;
+            }
+            connections.push_back({source, source_channel, destination, destination_channel});
+            compiled = false;
+            return true;
+        }
+
+        /**
+         * orders nodes by their dependencies and allocates all buffers
+         * @return false if the graph contains a cycle
+         */
+        bool compile() {
+            compiled = false;
+            const uint32_t num_nodes = static_cast<uint32_t>(nodes.size());
+            node_index.clear();
+            for (uint32_t i = 0; i < num_nodes; ++i) {
+                node_index[nodes[i].get()] = i;
+            }
+
+            std::vector<CompiledNode> graph(num_nodes);
+            for (uint32_t i = 0; i < num_nodes; ++i) {
+                CompiledNode& c = graph[i];
+                c.node          = nodes[i].get();
+                c.output_buffers.assign(c.node->num_outputs(), std::vector<float>(max_block_size, 0.0f));
+                for (auto& buffer: c.output_buffers) {
+                    c.outputs.push_back(buffer.data());
+                }
+                c.inputs.assign(c.node->num_inputs(), silence.data());
+            }
+
+            /* inputs and dependencies */
+            for (uint32_t i = 0; i < num_nodes; ++i) {
+                CompiledNode& c = graph[i];
+                for (uint32_t channel = 0; channel < c.node->num_inputs(); ++channel) {
+                    std::vector<const float*> sources;
+                    for (const auto& connection: connections) {
+                        if (connection.destination == c.node && connection.destination_channel == channel) {
+                            const uint32_t source = node_index[connection.source];
+                            sources.push_back(graph[source].outputs[connection.source_channel]);
+                            if (std::find(graph[source].successors.begin(), graph[source].successors.end(), i) == graph[source].successors.end()) {
+                                graph[source].successors.push_back(i);
+                                c.num_dependencies++;
+                            }
+                        }
+                    }
+                    if (sources.size() == 1) {
+                        c.inputs[channel] = sources[0]; // NOTE read directly from the output of the source
+                    } else if (sources.size() > 1) {
+                        c.input_mixes.push_back({std::vector<float>(max_block_size, 0.0f), std::move(sources)});
+                        c.inputs[channel] = c.input_mixes.back().buffer.data();
+                    }
+                }
+            }
+
+            /* detect cycles ( Kahn's algorithm ) */
+            std::vector<uint32_t> in_degree(num_nodes);
+            std::vector<uint32_t> order;
+            for (uint32_t i = 0; i < num_nodes; ++i) {
+                in_degree[i] = graph[i].num_dependencies;
+                if (in_degree[i] == 0) {
+                    order.push_back(i);
+                }
+            }
+            for (size_t i = 0; i < order.size(); ++i) {
+                for (const uint32_t successor: graph[order[i]].successors) {
+                    if (--in_degree[successor] == 0) {
+                        order.push_back(successor);
+                    }
+                }
+            }
+            if (order.size() != num_nodes) {
+                return false;
+            }
+
+            compiled_nodes = std::move(graph);
+            pending        = std::make_unique<std::atomic<uint32_t>[]>(num_nodes);
+            ready          = std::make_unique<std::atomic<int32_t>[]>(num_nodes);
+            compiled       = true;
+            return true;
+        }
+
+        /**
+         * processes all nodes for one block. `num_frames` is clamped to `max_block_size`. does nothing
+         * if the graph is not compiled.
+         */
+        void process(uint32_t num_frames) {
+            if (!compiled || compiled_nodes.empty()) {
+                return;
+            }
+            num_frames   = std::min(num_frames, max_block_size);
+            block_frames = num_frames;
+
+            const uint32_t num_nodes = static_cast<uint32_t>(compiled_nodes.size());
+            ready_head.store(0, std::memory_order_relaxed);
+            ready_tail.store(0, std::memory_order_relaxed);
+            for (uint32_t i = 0; i < num_nodes; ++i) {
+                pending[i].store(compiled_nodes[i].num_dependencies, std::memory_order_relaxed);
+                ready[i].store(-1, std::memory_order_relaxed);
+            }
+            for (uint32_t i = 0; i < num_nodes; ++i) {
+                if (compiled_nodes[i].num_dependencies == 0) {
+                    push_ready(i);
+                }
+            }
+            remaining = num_nodes; // NOTE publishes the block to the workers
+
+            if (!workers.empty()) {
+                block_generation.fetch_add(1, std::memory_order_release);
+                worker_wakeup.notify_all();
+            }
+            run_nodes();
+            while (active_workers > 0) {
+                // NOTE workers leave as soon as no node is left, this only waits for the last running node
+                std::this_thread::yield();
+            }
+        }
+
+        /**
+         * @return output channel of `node` from the last processed block or silence
+         */
+        const float* output(const AudioNode* node, const uint32_t channel) const {
+            const auto it = node_index.find(node);
+            if (!compiled || it == node_index.end() || channel >= node->num_outputs()) {
+                return silence.data();
+            }
+            return compiled_nodes[it->second].outputs[channel];
+        }
+
+        /**
+         * writes the output channels of `node` into an interleaved buffer e.g `audio_output_buffer`.
+         * channels the node does not have are silent.
+         */
+        void write_interleaved(const AudioNode* node, float* buffer, const uint32_t num_channels, uint32_t num_frames) const {
+            num_frames = std::min(num_frames, max_block_size);
+            if (num_channels == 2) {
+                AudioUtilities::interleave_stereo(output(node, 0), output(node, 1), buffer, num_frames);
+                return;
+            }
+            for (uint32_t channel = 0; channel < num_channels; ++channel) {
+                const float* signal = output(node, channel);
+                for (uint32_t i = 0; i < num_frames; ++i) {
+                    buffer[i * num_channels + channel] = signal[i];
+                }
+            }
+        }
+
+    private:
+        struct Connection {
+            AudioNode* source;
+            uint32_t   source_channel;
+            AudioNode* destination;
+            uint32_t   destination_channel;
+        };
+
+        struct InputMix {
+            std::vector<float>        buffer;
+            std::vector<const float*> sources;
+        };
+
+        struct CompiledNode {
+            AudioNode*                      node{nullptr};
+            std::vector<const float*>       inputs;
+            std::vector<float*>             outputs;
+            std::vector<std::vector<float>> output_buffers;
+            std::vector<InputMix>           input_mixes;
+            std::vector<uint32_t>           successors;
+            uint32_t                        num_dependencies{0};
+        };
+
+        static constexpr int   WORKER_SPIN_COUNT  = 1000;
+        static constexpr float CPU_TIME_SMOOTHING = 0.1f;
+
+        const uint32_t                                 max_block_size;
+        const std::vector<float>                       silence;
+        std::vector<std::unique_ptr<AudioNode>>        nodes;
+        std::vector<Connection>                        connections;
+        std::vector<CompiledNode>                      compiled_nodes;
+        std::unordered_map<const AudioNode*, uint32_t> node_index;
+        bool                                           compiled{false};
+
+        /* --- block state --- */
+        std::unique_ptr<std::atomic<uint32_t>[]> pending; // NOTE number of unfinished inputs per node
+        std::unique_ptr<std::atomic<int32_t>[]>  ready;   // NOTE queue of nodes ready to be processed
+        std::atomic<uint32_t>                    ready_head{0};
+        std::atomic<uint32_t>                    ready_tail{0};
+        std::atomic<uint32_t>                    remaining{0};
+        uint32_t                                 block_frames{0};
+
+        /* --- workers --- */
+        std::vector<std::thread> workers;
+        std::mutex               worker_mutex;
+        std::condition_variable  worker_wakeup;
+        std::atomic<uint64_t>    block_generation{0};
+        std::atomic<uint32_t>    active_workers{0};
+        bool                     running{true};
+
+        bool contains(const AudioNode* node) const {
+            return node != nullptr && std::any_of(nodes.begin(), nodes.end(), [node](const auto& n) { return n.get() == node; });
+        }
+
+        void push_ready(const uint32_t index) {
+            const uint32_t slot = ready_tail.fetch_add(1, std::memory_order_acq_rel);
+            ready[slot].store(static_cast<int32_t>(index), std::memory_order_release);
+        }
+
+        int32_t claim_ready_node() {
+            uint32_t head = ready_head.load(std::memory_order_acquire);
+            while (head < ready_tail.load(std::memory_order_acquire)) {
+                if (ready_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel)) {
+                    int32_t index;
+                    while ((index = ready[head].load(std::memory_order_acquire)) < 0) {
+                        // NOTE slot is claimed but the node is not yet stored by `push_ready`
+                    }
+                    return index;
+                }
+            }
+            return -1;
+        }
+
+        void run_nodes() {
+            while (remaining > 0) {
+                const int32_t index = claim_ready_node();
+                if (index < 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                run_node(compiled_nodes[index]);
+                for (const uint32_t successor: compiled_nodes[index].successors) {
+                    if (pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        push_ready(successor);
+                    }
+                }
+                remaining--;
+            }
+        }
+
+        void run_node(CompiledNode& c) const {
+            const uint32_t num_frames = block_frames;
+            for (auto& mix: c.input_mixes) {
+                float* buffer = mix.buffer.data();
+                std::copy_n(mix.sources[0], num_frames, buffer);
+                for (size_t s = 1; s < mix.sources.size(); ++s) {
+                    const float* source = mix.sources[s];
+                    for (uint32_t i = 0; i < num_frames; ++i) {
+                        buffer[i] += source[i];
+                    }
+                }
+            }
+            const auto start = std::chrono::steady_clock::now();
+            c.node->process(c.inputs.data(), c.outputs.data(), num_frames);
+            const std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            const float                                    average = c.node->cpu_time_us.load(std::memory_order_relaxed);
+            c.node->cpu_time_us.store(average + (elapsed.count() - average) * CPU_TIME_SMOOTHING, std::memory_order_relaxed);
+        }
+
+        void worker_loop() {
+            uint64_t seen_generation = 0;
+            bool     spin            = false; // NOTE only spin right after a block, idle workers sleep
+            while (true) {
+                uint64_t generation = block_generation.load(std::memory_order_acquire);
+                if (spin) {
+                    for (int i = 0; i < WORKER_SPIN_COUNT && generation == seen_generation; ++i) {
+                        std::this_thread::yield();
+                        generation = block_generation.load(std::memory_order_acquire);
+                    }
+                    spin = false;
+                }
+                if (generation == seen_generation) {
+                    // NOTE the timeout only recovers from a wakeup missed because `process` notifies without the lock
+                    std::unique_lock lock(worker_mutex);
+                    worker_wakeup.wait_for(lock, std::chrono::milliseconds(1), [&] {
+                        return !running || block_generation.load(std::memory_order_acquire) != seen_generation;
+                    });
+                    if (!running) {
+                        return;
+                    }
+                    continue;
+                }
+                seen_generation = generation;
+                active_workers++;
+                run_nodes();
+                active_workers--;
+                spin = true;
+            }
+        }
+    };
+} // namespace umfeld
@@ -576,6 +576,16 @@ namespace umfeld {
             }
         }
 
+        /**
+         * multiplies buffer with a linear ramp i.e sample `i` is multiplied with `start + increment * (i + 1)`.
+         * the gain is computed from the index and not accumulated, so the loop can be vectorized.
+         */
+        static void mult_ramp(float* buffer, const float start, const float increment, const uint32_t length) {
+            for (uint32_t i = 0; i < length; i++) {
+                buffer[i] *= start + increment * static_cast<float>(i + 1);
+            }
+        }
+
         /**
          * divides buffer_b from buffer_a. result will be stored in buffer_a, buffer_b will not be changed.
          */
@@ -591,6 +601,28 @@ namespace umfeld {
             }
         }
 
+        /**
+         * writes two mono buffers into an interleaved stereo buffer ( L R L R … ) of `length` frames.
+         * the buffers must not overlap.
+         */
+        static void interleave_stereo(const float* left, const float* right, float* interleaved, const uint32_t length) {
+            for (uint32_t i = 0; i < length; i++) {
+                interleaved[i * 2]     = left[i];
+                interleaved[i * 2 + 1] = right[i];
+            }
+        }
+
+        /**
+         * splits an interleaved stereo buffer ( L R L R … ) of `length` frames into two mono buffers.
+         * the buffers must not overlap.
+         */
+        static void deinterleave_stereo(const float* interleaved, float* left, float* right, const uint32_t length) {
+            for (uint32_t i = 0; i < length; i++) {
+                left[i]  = interleaved[i * 2];
+                right[i] = interleaved[i * 2 + 1];
+            }
+        }
+
 
         /**
          * usage:
@@ -82,9 +82,30 @@ namespace umfeld {
 
         void process(float*         signal_buffer,
                      const uint32_t length) {
+            // NOTE the recursion prevents processing several samples at once. coefficients and state
+            //      are kept in registers though, as writes to `signal_buffer` might otherwise alias them.
+            const float a0 = biquad_a0;
+            const float a1 = biquad_a1;
+            const float a2 = biquad_a2;
+            const float a3 = biquad_a3;
+            const float a4 = biquad_a4;
+            float       x1 = biquad_x1;
+            float       x2 = biquad_x2;
+            float       y1 = biquad_y1;
+            float       y2 = biquad_y2;
             for (uint32_t i = 0; i < length; i++) {
-                signal_buffer[i] = process(signal_buffer[i]);
+                const float sample = signal_buffer[i];
+                const float result = (a0 * sample + a1 * x1) + (a2 * x2 - a3 * y1 - a4 * y2);
+                x2                 = x1;
+                x1                 = sample;
+                y2                 = y1;
+                y1                 = result;
+                signal_buffer[i]   = result;
             }
+            biquad_x1 = x1;
+            biquad_x2 = x2;
+            biquad_y1 = y1;
+            biquad_y2 = y2;
         }
 
         void set(uint8_t type,
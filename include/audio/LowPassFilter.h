@@ -75,51 +75,17 @@ namespace umfeld {
 
         void process(float*         signal_buffer,
                      const uint32_t length) {
+            // NOTE frequency and resonance are only evaluated once per block
+            const float res4 = update_coefficients();
+            const float tune = fOldTune;
             for (uint32_t i = 0; i < length; i++) {
-                signal_buffer[i] = process(signal_buffer[i]);
+                signal_buffer[i] = process_sample(signal_buffer[i], res4, tune);
             }
         }
 
-        float process(float signal) {
-            const float     freq = fCutoffFrequency;
-            const float     res  = std::max(fResonance, 0.0f);
-            float           stg[4];
-            float           acr, tune;
-            constexpr float THERMAL = 0.000025f;
-
-            if (fOldFreq != freq || fOldRes != res) {
-                fOldFreq        = freq;
-                const float fc  = (freq / fSampleRate);
-                const float f   = 0.5f * fc;
-                const float fc2 = fc * fc;
-                const float fc3 = fc2 * fc2;
-                const float fcr = 1.8730f * fc3 + 0.4955f * fc2 - 0.6490f * fc + 0.9988f;
-                acr             = -3.9364f * fc2 + 1.8409f * fc + 0.9968f;
-                tune            = (1.0f - std::exp(-((2 * static_cast<float>(M_PI)) * f * fcr))) / THERMAL;
-
-                fOldRes  = res;
-                fOldAcr  = acr;
-                fOldTune = tune;
-            } else {
-                //            res = mOldRes;
-                acr  = fOldAcr;
-                tune = fOldTune;
-            }
-
-            const float res4 = 4.0f * res * acr;
-
-            for (uint8_t j = 0; j < 2; j++) {
-                signal -= res4 * fDelay[5];
-                fDelay[0] = stg[0] = fDelay[0] + tune * (my_tanh(signal * THERMAL) - fTanhstg[0]);
-                for (uint8_t k = 1; k < 4; k++) {
-                    signal    = stg[k - 1];
-                    stg[k]    = fDelay[k] + tune * ((fTanhstg[k - 1] = my_tanh(signal * THERMAL)) - (k != 3 ? fTanhstg[k] : my_tanh(fDelay[k] * THERMAL)));
-                    fDelay[k] = stg[k];
-                }
-                fDelay[5] = (stg[3] + fDelay[4]) * 0.5f;
-                fDelay[4] = stg[3];
-            }
-            return fDelay[5] * amplification;
+        float process(const float signal) {
+            const float res4 = update_coefficients();
+            return process_sample(signal, res4, fOldTune);
         }
 
         float get_frequency() const {
@@ -153,6 +119,45 @@ namespace umfeld {
         }
 
     private:
+        static constexpr float THERMAL = 0.000025f;
+
+        /**
+         * recomputes the coefficients if frequency or resonance changed
+         * @return resonance feedback factor
+         */
+        float update_coefficients() {
+            const float freq = fCutoffFrequency;
+            const float res  = std::max(fResonance, 0.0f);
+            if (fOldFreq != freq || fOldRes != res) {
+                fOldFreq        = freq;
+                const float fc  = (freq / fSampleRate);
+                const float f   = 0.5f * fc;
+                const float fc2 = fc * fc;
+                const float fc3 = fc2 * fc2;
+                const float fcr = 1.8730f * fc3 + 0.4955f * fc2 - 0.6490f * fc + 0.9988f;
+                fOldAcr         = -3.9364f * fc2 + 1.8409f * fc + 0.9968f;
+                fOldTune        = (1.0f - std::exp(-((2 * static_cast<float>(M_PI)) * f * fcr))) / THERMAL;
+                fOldRes         = res;
+            }
+            return 4.0f * res * fOldAcr;
+        }
+
+        float process_sample(float signal, const float res4, const float tune) {
+            float stg[4];
+            for (uint8_t j = 0; j < 2; j++) {
+                signal -= res4 * fDelay[5];
+                fDelay[0] = stg[0] = fDelay[0] + tune * (my_tanh(signal * THERMAL) - fTanhstg[0]);
+                for (uint8_t k = 1; k < 4; k++) {
+                    signal    = stg[k - 1];
+                    stg[k]    = fDelay[k] + tune * ((fTanhstg[k - 1] = my_tanh(signal * THERMAL)) - (k != 3 ? fTanhstg[k] : my_tanh(fDelay[k] * THERMAL)));
+                    fDelay[k] = stg[k];
+                }
+                fDelay[5] = (stg[3] + fDelay[4]) * 0.5f;
+                fDelay[4] = stg[3];
+            }
+            return fDelay[5] * amplification;
+        }
+
         static float my_tanh(float x) {
             float sign = 1;
             if (x < 0) {
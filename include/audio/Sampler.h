@@ -36,6 +36,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "AudioUtilities.h"
@@ -267,7 +268,17 @@ namespace umfeld {
         }
 
         void process(float* signal_buffer, const uint32_t buffer_length) {
-            for (uint16_t i = 0; i < buffer_length; i++) {
+            if (fBufferLength == 0 || !fIsPlaying) {
+                notifyListeners(); // "buffer is empty" or "not playing"
+                std::fill_n(signal_buffer, buffer_length, 0.0f);
+                return;
+            }
+
+            validateInOutPoints();
+            uint32_t i = fInterpolateSamples ? process_block<true>(signal_buffer, buffer_length) : process_block<false>(signal_buffer, buffer_length);
+
+            /* continue sample by sample once playback reached an end ( listeners might have changed the sampler ) */
+            for (; i < buffer_length; i++) {
                 signal_buffer[i] = process();
             }
         }
@@ -477,6 +488,59 @@ namespace umfeld {
             return fBufferLength - 1;
         }
 
+        /**
+         * same as `process()` for a whole block with checks that do not change during a block moved out
+         * of the loop. stops after the sample on which playback reached an end.
+         * @return number of samples written
+         */
+        template<bool INTERPOLATE>
+        uint32_t process_block(float* signal_buffer, const uint32_t buffer_length) {
+            const bool    forward   = fDirectionForward;
+            const float   step      = forward ? fStepSize : -fStepSize;
+            const float   amplitude = fAmplitude;
+            const int32_t edge_fade = fEdgeFadePadding;
+            float         index     = fBufferIndex;
+            for (uint32_t i = 0; i < buffer_length; i++) {
+                index += step;
+                const int32_t mRoundedIndex = static_cast<int32_t>(index);
+                const float   mFrac         = index - mRoundedIndex;
+                const int32_t mCurrentIndex = wrapIndex(mRoundedIndex);
+                index                       = mCurrentIndex + mFrac;
+
+                if (forward ? mCurrentIndex >= fOutPoint : mCurrentIndex <= fInPoint) {
+                    fBufferIndex = index;
+                    if (i > 0) {
+                        fIsFlaggedDone = false;
+                    }
+                    notifyListeners(); // "reached end"
+                    signal_buffer[i] = 0.0f;
+                    return i + 1;
+                }
+
+                float mSample = convert_sample(fBuffer[mCurrentIndex]);
+                if (INTERPOLATE) {
+                    const float mNextSample = convert_sample(fBuffer[wrapIndex(mCurrentIndex + 1)]);
+                    mSample                 = mSample * (1.0f - mFrac) + mNextSample * mFrac;
+                }
+                mSample *= amplitude;
+
+                if (edge_fade > 0) {
+                    const int32_t mRelativeIndex = fBufferLength - mCurrentIndex;
+                    if (mCurrentIndex < edge_fade) {
+                        mSample *= static_cast<float>(mCurrentIndex) / edge_fade;
+                    } else if (mRelativeIndex < edge_fade) {
+                        mSample *= static_cast<float>(mRelativeIndex) / edge_fade;
+                    }
+                }
+                signal_buffer[i] = mSample;
+            }
+            fBufferIndex = index;
+            if (buffer_length > 0) {
+                fIsFlaggedDone = false;
+            }
+            return buffer_length;
+        }
+
         void notifyListeners() {
             if (!fIsFlaggedDone) {
                 for (SamplerListener* l: fSamplerListeners) {
@@ -0,0 +1,457 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * PROCESSOR INTERFACE
+ *
+ * - [ ] float process()
+ * - [ ] float process(float)
+ * - [ ] void process(AudioSignal&)
+ * - [x] void process(float*, uint32_t) *overwrite*
+ * - [ ] void process(float*, float*, uint32_t)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ADSR.h"
+#include "AudioEventQueue.h"
+#include "AudioUtilities.h"
+#include "Filter.h"
+#include "Sampler.h"
+#include "Wavetable.h"
+
+namespace umfeld {
+    /**
+     * voice made of an oscillator, an optional filter and an envelope.
+     */
+    class SynthVoice {
+    public:
+        Wavetable oscillator;
+        Filter    filter;
+        ADSR      envelope;
+        bool      enable_filter{false};
+
+        explicit SynthVoice(const float sample_rate, const uint32_t wavetable_size = 512) : oscillator(wavetable_size, sample_rate),
+                                                                                            filter(sample_rate),
+                                                                                            envelope(sample_rate) {
+            oscillator.set_waveform(WAVEFORM_SINE);
+            filter.reset();
+        }
+
+        /**
+         * @param wavetable wavetable shared by all voices e.g to save memory with large polyphony
+         */
+        SynthVoice(const float sample_rate, float* wavetable, const uint32_t wavetable_size) : oscillator(wavetable, wavetable_size, sample_rate),
+                                                                                               filter(sample_rate),
+                                                                                               envelope(sample_rate) {
+            filter.reset();
+        }
+
+        void note_on(const uint8_t note, const float velocity) {
+            oscillator.set_frequency(AudioUtilities::midi_note_to_frequency(note));
+            oscillator.set_amplitude(velocity);
+            envelope.start();
+        }
+
+        void note_off() {
+            envelope.stop();
+        }
+
+        bool is_active() const {
+            return !envelope.is_idle();
+        }
+
+        float level() const {
+            return envelope.current() * oscillator.get_amplitude();
+        }
+
+        void process(float* signal_buffer, const uint32_t buffer_length) {
+            oscillator.process(signal_buffer, buffer_length);
+            if (enable_filter) {
+                filter.process(signal_buffer, buffer_length);
+            }
+            envelope.process(signal_buffer, buffer_length);
+        }
+    };
+
+    /**
+     * voice playing a sample buffer ( usually shared by all voices ) through an envelope. the sample
+     * is assumed to be tuned to middle C ( MIDI note 60 ) unless `tune_frequency_to` is called on the
+     * sampler.
+     */
+    class SamplerVoice {
+    public:
+        Sampler sampler;
+        ADSR    envelope;
+
+        SamplerVoice(float* buffer, const int32_t buffer_length, const float sample_rate) : sampler(buffer, buffer_length, sample_rate),
+                                                                                            envelope(sample_rate) {
+            sampler.enable_loop(false);
+            sampler.tune_frequency_to(AudioUtilities::midi_note_to_frequency(60));
+        }
+
+        void note_on(const uint8_t note, const float velocity) {
+            sampler.set_frequency(AudioUtilities::midi_note_to_frequency(note));
+            sampler.set_amplitude(velocity);
+            sampler.rewind();
+            sampler.play();
+            envelope.start();
+        }
+
+        void note_off() {
+            envelope.stop();
+        }
+
+        bool is_active() const {
+            return !envelope.is_idle() && (sampler.is_looping() || sampler.get_position() < sampler.get_out());
+        }
+
+        float level() const {
+            return envelope.current() * sampler.get_amplitude();
+        }
+
+        void process(float* signal_buffer, const uint32_t buffer_length) {
+            sampler.process(signal_buffer, buffer_length);
+            envelope.process(signal_buffer, buffer_length);
+        }
+    };
+
+    enum VoiceStealing {
+        VOICE_STEAL_OLDEST = 0,
+        VOICE_STEAL_QUIETEST,
+    };
+
+    /**
+     * preallocates a fixed number of voices, assigns them to notes and mixes all active voices.
+     * inactive voices are skipped entirely. if all voices are busy a note steals the oldest or the
+     * quietest voice.
+     *
+     * a voice type needs to provide:
+     *
+     * <code>
+     * void  note_on(uint8_t note, float velocity);
+     * void  note_off();
+     * bool  is_active() const;
+     * float level() const;
+     * void  process(float* signal_buffer, uint32_t buffer_length); // overwrites buffer
+     * </code>
+     *
+     * e.g:
+     *
+     * <code>
+     * VoicePool<SynthVoice> pool{128, 1024, audio_sample_rate};
+     * pool.note_on(60, 0.5f);
+     * ...
+     * pool.process(audio_output_buffer, audio_buffer_size);
+     * </code>
+     *
+     * `note_on`, `note_off` and `process` must be called from the same thread ( usually the audio
+     * thread ). notes from the draw thread can be passed via an `AudioEventQueue` and `handle_event`.
+     */
+    template<class VOICE = SynthVoice>
+    class VoicePool {
+    public:
+        /**
+         * @param num_voices     number of voices
+         * @param max_block_size largest block passed to `process` without being split
+         * @param voice_args     arguments passed to the constructor of every voice
+         */
+        template<typename... Args>
+        explicit VoicePool(const uint32_t num_voices, const uint32_t max_block_size, Args&&... voice_args)
+            : max_block_size(std::max(max_block_size, 1u)) {
+            voices.reserve(num_voices);
+            slots.resize(num_voices);
+            active_voices.reserve(num_voices);
+            for (uint32_t i = 0; i < num_voices; ++i) {
+                voices.emplace_back(std::make_unique<VOICE>(voice_args...));
+            }
+            set_num_threads(1);
+        }
+
+        ~VoicePool() {
+            stop_workers();
+        }
+
+        VoicePool(const VoicePool&)            = delete;
+        VoicePool& operator=(const VoicePool&) = delete;
+
+        uint32_t num_voices() const { return static_cast<uint32_t>(voices.size()); }
+        VOICE&   voice(const uint32_t index) { return *voices[index]; }
+
+        uint32_t num_active_voices() const {
+            uint32_t count = 0;
+            for (const auto& v: voices) {
+                count += v->is_active() ? 1 : 0;
+            }
+            return count;
+        }
+
+        void set_voice_stealing(const VoiceStealing stealing) {
+            voice_stealing = stealing;
+        }
+
+        /**
+         * mixes voices on `num_threads` threads ( including the calling thread ) once at least
+         * `min_voices_per_thread` voices per thread are active. workers are handed blocks without
+         * locks like in `AudioGraph`. must not be called while `process` is running.
+         */
+        void set_num_threads(const unsigned num_threads, const uint32_t min_voices_per_thread = 16) {
+            const unsigned threads = std::max(num_threads, 1u);
+            stop_workers();
+            running = true;
+            for (unsigned i = 1; i < threads; ++i) {
+                workers.emplace_back([this] { worker_loop(); });
+            }
+            parallel_min_voices = threads * std::max(min_voices_per_thread, 1u);
+            mix_buffers.assign(threads, std::vector<float>(max_block_size));
+            voice_buffers.assign(threads, std::vector<float>(max_block_size));
+        }
+
+        /**
+         * starts a note on a free voice or steals one if all voices are busy. a note that is already
+         * held is retriggered on the same voice.
+         */
+        VOICE* note_on(const uint8_t note, const float velocity) {
+            if (voices.empty()) {
+                return nullptr;
+            }
+            const uint32_t index = find_voice(note);
+            slots[index].note    = note;
+            slots[index].held    = true;
+            slots[index].started = ++note_counter;
+            voices[index]->note_on(note, velocity);
+            return voices[index].get();
+        }
+
+        /**
+         * releases all voices holding `note`
+         */
+        void note_off(const uint8_t note) {
+            for (uint32_t i = 0; i < voices.size(); ++i) {
+                if (slots[i].held && slots[i].note == note) {
+                    slots[i].held = false;
+                    voices[i]->note_off();
+                }
+            }
+        }
+
+        void all_notes_off() {
+            for (uint32_t i = 0; i < voices.size(); ++i) {
+                if (slots[i].held) {
+                    slots[i].held = false;
+                    voices[i]->note_off();
+                }
+            }
+        }
+
+        /**
+         * handles `AUDIO_EVENT_NOTE_ON` and `AUDIO_EVENT_NOTE_OFF` with `parameter` as note and `value`
+         * as velocity. other events are ignored.
+         */
+        void handle_event(const AudioEvent& event) {
+            if (event.type == AUDIO_EVENT_NOTE_ON) {
+                note_on(static_cast<uint8_t>(event.parameter), event.value);
+            } else if (event.type == AUDIO_EVENT_NOTE_OFF) {
+                note_off(static_cast<uint8_t>(event.parameter));
+            }
+        }
+
+        /**
+         * mixes all active voices into `signal_buffer` ( overwriting it )
+         */
+        void process(float* signal_buffer, uint32_t buffer_length) {
+            while (buffer_length > 0) {
+                const uint32_t length = std::min(buffer_length, max_block_size);
+                process_block(signal_buffer, length);
+                signal_buffer += length;
+                buffer_length -= length;
+            }
+        }
+
+    private:
+        struct Slot {
+            uint64_t started{0};
+            uint8_t  note{0};
+            bool     held{false};
+        };
+
+        static constexpr int WORKER_SPIN_COUNT = 1000;
+
+        const uint32_t                      max_block_size;
+        std::vector<std::unique_ptr<VOICE>> voices;
+        std::vector<Slot>                   slots;
+        std::vector<uint32_t>               active_voices;
+        std::vector<std::vector<float>>     mix_buffers;   // NOTE one per thread
+        std::vector<std::vector<float>>     voice_buffers; // NOTE one per thread
+        size_t                              mix_num_tasks{1};
+        uint32_t                            mix_length{0};
+        uint32_t                            parallel_min_voices{0};
+        uint64_t                            note_counter{0};
+        VoiceStealing                       voice_stealing{VOICE_STEAL_OLDEST};
+
+        /* --- workers --- */
+        std::vector<std::thread> workers;
+        std::mutex               worker_mutex;
+        std::condition_variable  worker_wakeup;
+        std::atomic<uint64_t>    block_generation{0};
+        std::atomic<uint32_t>    next_task{0};
+        std::atomic<uint32_t>    remaining{0};
+        std::atomic<uint32_t>    active_workers{0};
+        bool                     running{true};
+
+        uint32_t find_voice(const uint8_t note) const {
+            for (uint32_t i = 0; i < voices.size(); ++i) {
+                if (slots[i].held && slots[i].note == note) {
+                    return i;
+                }
+            }
+            for (uint32_t i = 0; i < voices.size(); ++i) {
+                if (!voices[i]->is_active()) {
+                    return i;
+                }
+            }
+            uint32_t candidate = 0;
+            for (uint32_t i = 1; i < voices.size(); ++i) {
+                if (voice_stealing == VOICE_STEAL_QUIETEST) {
+                    if (voices[i]->level() < voices[candidate]->level()) {
+                        candidate = i;
+                    }
+                } else if (slots[i].started < slots[candidate].started) {
+                    candidate = i;
+                }
+            }
+            return candidate;
+        }
+
+        /**
+         * mixes every `stride`-th active voice starting at `task` into the mix buffer of `task`
+         */
+        void mix_voices(const size_t task, const size_t stride) {
+            float* mix   = mix_buffers[task].data();
+            float* voice = voice_buffers[task].data();
+            std::fill_n(mix, mix_length, 0.0f);
+            for (size_t i = task; i < active_voices.size(); i += stride) {
+                voices[active_voices[i]]->process(voice, mix_length);
+                AudioUtilities::add(mix, voice, mix_length);
+            }
+        }
+
+        void process_block(float* signal_buffer, const uint32_t length) {
+            active_voices.clear();
+            for (uint32_t i = 0; i < voices.size(); ++i) {
+                if (voices[i]->is_active()) {
+                    active_voices.push_back(i);
+                }
+            }
+
+            std::fill_n(signal_buffer, length, 0.0f);
+            if (active_voices.empty()) {
+                return;
+            }
+
+            mix_length = length;
+            if (!workers.empty() && active_voices.size() >= parallel_min_voices) {
+                mix_num_tasks = mix_buffers.size();
+                next_task     = 0;
+                remaining     = static_cast<uint32_t>(mix_num_tasks); // NOTE publishes the block to the workers
+                block_generation.fetch_add(1, std::memory_order_release);
+                worker_wakeup.notify_all();
+                run_tasks();
+                while (remaining > 0 || active_workers > 0) {
+                    // NOTE workers leave as soon as no task is left, this only waits for the last running task
+                    std::this_thread::yield();
+                }
+                for (size_t task = 0; task < mix_num_tasks; ++task) {
+                    AudioUtilities::add(signal_buffer, mix_buffers[task].data(), length);
+                }
+            } else {
+                float* voice = voice_buffers[0].data();
+                for (const uint32_t index: active_voices) {
+                    voices[index]->process(voice, length);
+                    AudioUtilities::add(signal_buffer, voice, length);
+                }
+            }
+        }
+
+        void run_tasks() {
+            while (remaining > 0) {
+                const uint32_t task = next_task.fetch_add(1);
+                if (task >= mix_num_tasks) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                mix_voices(task, mix_num_tasks);
+                remaining--;
+            }
+        }
+
+        void worker_loop() {
+            uint64_t seen_generation = block_generation.load(std::memory_order_acquire);
+            bool     spin            = false; // NOTE only spin right after a block, idle workers sleep
+            while (true) {
+                uint64_t generation = block_generation.load(std::memory_order_acquire);
+                if (spin) {
+                    for (int i = 0; i < WORKER_SPIN_COUNT && generation == seen_generation; ++i) {
+                        std::this_thread::yield();
+                        generation = block_generation.load(std::memory_order_acquire);
+                    }
+                    spin = false;
+                }
+                if (generation == seen_generation) {
+                    // NOTE the timeout only recovers from a wakeup missed because `process` notifies without the lock
+                    std::unique_lock lock(worker_mutex);
+                    worker_wakeup.wait_for(lock, std::chrono::milliseconds(1), [&] {
+                        return !running || block_generation.load(std::memory_order_acquire) != seen_generation;
+                    });
+                    if (!running) {
+                        return;
+                    }
+                    continue;
+                }
+                seen_generation = generation;
+                active_workers++;
+                run_tasks();
+                active_workers--;
+                spin = true;
+            }
+        }
+
+        void stop_workers() {
+            {
+                std::lock_guard lock(worker_mutex);
+                running = false;
+            }
+            worker_wakeup.notify_all();
+            for (auto& worker: workers) {
+                worker.join();
+            }
+            workers.clear();
+        }
+    };
+} // namespace umfeld
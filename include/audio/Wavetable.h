@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
 
@@ -411,12 +412,80 @@ namespace umfeld {
         }
 
         void process(float* signal_buffer, const uint32_t buffer_length) {
-            for (uint16_t i = 0; i < buffer_length; i++) {
+            /* frequency ramps change the step size on every sample */
+            uint32_t i = 0;
+            while (i < buffer_length && mDesiredFrequencySteps > 0) {
+                signal_buffer[i++] = process();
+            }
+            if (i == buffer_length) {
+                return;
+            }
+#if AudioUtilities_WAVETABLE_INTERPOLATE_SAMPLES == 0
+            float*         buffer = signal_buffer + i;
+            const uint32_t length = buffer_length - i;
+
+            /* table lookup with constant step size */
+            // NOTE the phase of every frame is computed from the start of the block ( and not accumulated )
+            //      so that frames do not depend on each other and the index computation can be vectorized.
+            //      the phase is rewrapped every `PHASE_CHUNK` frames to keep the integer index in range.
+            const double size = static_cast<double>(mWavetableSize);
+            double       step = std::fmod(static_cast<double>(mStepSize), size);
+            if (step < 0.0) {
+                step += size; // NOTE walking backwards equals walking forward by the remainder
+            }
+            double     phase          = mArrayPtr;
+            const bool power_of_two   = (mWavetableSize & (mWavetableSize - 1)) == 0;
+            const auto wavetable_mask = static_cast<int32_t>(mWavetableSize - 1);
+            const auto wavetable_size = static_cast<int32_t>(mWavetableSize);
+            for (uint32_t start = 0; start < length; start += PHASE_CHUNK) {
+                float*         chunk        = buffer + start;
+                const uint32_t chunk_length = std::min(length - start, PHASE_CHUNK);
+                if (power_of_two) {
+                    for (uint32_t j = 0; j < chunk_length; j++) {
+                        chunk[j] = mWavetable[static_cast<int32_t>(phase + step * j) & wavetable_mask];
+                    }
+                } else {
+                    for (uint32_t j = 0; j < chunk_length; j++) {
+                        chunk[j] = mWavetable[static_cast<int32_t>(phase + step * j) % wavetable_size];
+                    }
+                }
+                phase = std::fmod(phase + step * chunk_length, size);
+            }
+            mArrayPtr = static_cast<float>(phase);
+            if (mArrayPtr >= mWavetableSize) {
+                mArrayPtr = 0.0f; // NOTE rounding to float may reach the end of the table
+            }
+
+            /* amplitude ( ramp ) and offset */
+            uint32_t j = 0;
+            if (mDesiredAmplitudeSteps > 0) {
+                const bool     ramp_ends = mDesiredAmplitudeSteps <= length;
+                const uint32_t ramp      = ramp_ends ? mDesiredAmplitudeSteps - 1 : length;
+                AudioUtilities::mult_ramp(buffer, mAmplitude, mDesiredAmplitudeFraction, ramp);
+                mAmplitude += mDesiredAmplitudeFraction * static_cast<float>(ramp);
+                mDesiredAmplitudeSteps -= ramp;
+                j = ramp;
+                if (ramp_ends) {
+                    mDesiredAmplitudeSteps = 0;
+                    mAmplitude             = mDesiredAmplitude;
+                    buffer[j++] *= mAmplitude;
+                }
+                AudioUtilities::add(buffer, mOffset, j);
+            }
+            for (; j < length; j++) {
+                buffer[j] = buffer[j] * mAmplitude + mOffset;
+            }
+            mSignal = buffer[length - 1];
+#else
+            for (; i < buffer_length; i++) {
                 signal_buffer[i] = process();
             }
+#endif // AudioUtilities_WAVETABLE_INTERPOLATE_SAMPLES
         }
 
     private:
+        static constexpr uint32_t PHASE_CHUNK = 1024; // NOTE frames between phase rewraps in `process`
+
         static constexpr float PIf                 = (float) PI;
         static constexpr float TWO_PIf             = (float) TWO_PI;
         static constexpr float M_DEFAULT_AMPLITUDE = 0.75f;
@@ -31,8 +31,10 @@ namespace umfeld {
 
             out vec4 vColor;
 
-            uniform mat4 uProjection;
-            uniform mat4 uViewMatrix;
+            layout(std140) uniform uMatrices {
+                mat4 uProjection;
+                mat4 uViewMatrix;
+            };
             uniform mat4 uModelMatrix;
 
             void main() {
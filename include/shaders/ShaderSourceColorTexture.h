@@ -34,8 +34,10 @@ namespace umfeld {
             out vec4 vColor;
             out vec2 vTexCoord;
 
-            uniform mat4 uProjection;
-            uniform mat4 uViewMatrix;
+            layout(std140) uniform uMatrices {
+                mat4 uProjection;
+                mat4 uViewMatrix;
+            };
             uniform mat4 uModelMatrix;
 
             void main() {
@@ -0,0 +1,108 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ShaderSource.h"
+
+namespace umfeld {
+    /*
+     * weighted blended order-independent transparency ( McGuire + Bavoil 2013 )
+     *
+     * NOTE OpenGL 3.3 has no per draw buffer blend functions. both targets are blended with
+     *      `glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA)` i.e RGB is
+     *      accumulated additively while alpha is multiplied by `1 - alpha`:
+     *
+     *      - target 0 :: RGB = sum( color * alpha * weight ), A = product( 1 - alpha ) ( revealage )
+     *      - target 1 :: R   = sum( alpha * weight )
+     */
+    inline ShaderSource shader_source_oit_accumulate{
+        .vertex   = R"(
+            #version 330 core
+
+            layout(location = 0) in vec4 aPosition;
+            layout(location = 1) in vec4 aNormal;
+            layout(location = 2) in vec4 aColor;
+            layout(location = 3) in vec2 aTexCoord;
+
+            out vec4 vColor;
+            out vec2 vTexCoord;
+
+            layout(std140) uniform uMatrices {
+                mat4 uProjection;
+                mat4 uViewMatrix;
+            };
+            uniform mat4 uModelMatrix;
+
+            void main() {
+                gl_Position = uProjection * uViewMatrix * uModelMatrix * aPosition;
+                vColor = aColor;
+                vTexCoord = aTexCoord;
+            }
+        )",
+        .fragment = R"(
+            #version 330 core
+
+            in vec4 vColor;
+            in vec2 vTexCoord;
+
+            layout(location = 0) out vec4 Accumulation;
+            layout(location = 1) out vec4 Weight;
+
+            uniform sampler2D uTexture;
+
+            void main() {
+                vec4  color  = texture(uTexture, vTexCoord) * vColor;
+                float weight = clamp(pow(min(1.0, color.a * 10.0) + 0.01, 3.0) * 1e8 *
+                                     pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+                Accumulation = vec4(color.rgb * color.a * weight, color.a);
+                Weight       = vec4(color.a * weight, 0.0, 0.0, color.a);
+            }
+        )"};
+
+    inline ShaderSource shader_source_oit_composite{
+        .vertex   = R"(
+            #version 330 core
+
+            void main() {
+                // NOTE fullscreen triangle, no vertex attributes required
+                vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+                gl_Position   = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+            }
+        )",
+        .fragment = R"(
+            #version 330 core
+
+            out vec4 FragColor;
+
+            uniform sampler2D uAccumulation;
+            uniform sampler2D uWeight;
+
+            void main() {
+                ivec2 coord        = ivec2(gl_FragCoord.xy);
+                vec4  accumulation = texelFetch(uAccumulation, coord, 0);
+                float revealage    = accumulation.a;
+                if (revealage >= 1.0) {
+                    discard;
+                }
+                float weight = max(texelFetch(uWeight, coord, 0).r, 1e-5);
+                FragColor    = vec4(accumulation.rgb / weight, 1.0 - revealage);
+            }
+        )"};
+}
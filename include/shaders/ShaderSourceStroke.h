@@ -0,0 +1,224 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ShaderSource.h"
+
+namespace umfeld {
+    /*
+     * expands line segments to stroke geometry in screen space. segments are submitted as
+     * `GL_LINES_ADJACENCY` i.e `( previous, start, end, next )`. texture coordinates carry the stroke
+     * parameters:
+     *
+     * - `x` :: stroke weight ( in pixels )
+     * - `y` :: `join * 4 + cap` on segment vertices, `-1` on adjacent vertices without neighbor
+     *
+     * joins are emitted at the end of each segment on the outer side of the turn, caps at open ends.
+     */
+    inline ShaderSource shader_source_stroke{
+        .vertex   = R"(
+            #version 330 core
+
+            layout(location = 0) in vec4 aPosition;
+            layout(location = 2) in vec4 aColor;
+            layout(location = 3) in vec2 aTexCoord;
+
+            out VertexData {
+                vec4 color;
+                vec2 stroke;
+            } vs_out;
+
+            layout(std140) uniform uMatrices {
+                mat4 uProjection;
+                mat4 uViewMatrix;
+            };
+            uniform mat4 uModelMatrix;
+
+            void main() {
+                gl_Position   = uProjection * uViewMatrix * uModelMatrix * aPosition;
+                vs_out.color  = aColor;
+                vs_out.stroke = aTexCoord;
+            }
+        )",
+        .fragment = R"(
+            #version 330 core
+
+            in vec4 vColor;
+
+            out vec4 FragColor;
+
+            void main() {
+                FragColor = vColor;
+            }
+        )",
+        .geometry = R"(
+            #version 330 core
+
+            layout(lines_adjacency) in;
+            layout(triangle_strip, max_vertices = 76) out;
+
+            in VertexData {
+                vec4 color;
+                vec2 stroke;
+            } gs_in[];
+
+            out vec4 vColor;
+
+            uniform vec2  uViewport;
+            uniform float uMiterMaxAngle;
+            uniform float uJoinRoundResolution;
+            uniform float uCapRoundResolution;
+
+            const int JOIN_BEVEL  = 0;
+            const int JOIN_MITER  = 1;
+            const int JOIN_ROUND  = 2;
+            const int CAP_PROJECT = 1;
+            const int CAP_ROUND   = 2;
+            const int CAP_POINTED = 3;
+
+            const int   MAX_ROUND_SEGMENTS = 12;
+            const float EPSILON            = 0.0001;
+
+            vec2 to_screen(vec4 p) {
+                return p.xy / p.w * 0.5 * uViewport;
+            }
+
+            void emit(vec2 p, vec4 reference, vec4 color) {
+                gl_Position = vec4(p / (0.5 * uViewport) * reference.w, reference.z, reference.w);
+                vColor      = color;
+                EmitVertex();
+            }
+
+            void emit_triangle(vec2 a, vec2 b, vec2 c, vec4 reference, vec4 color) {
+                emit(a, reference, color);
+                emit(b, reference, color);
+                emit(c, reference, color);
+                EndPrimitive();
+            }
+
+            vec2 rotate(vec2 v, float angle) {
+                float c = cos(angle);
+                float s = sin(angle);
+                return vec2(v.x * c - v.y * s, v.x * s + v.y * c);
+            }
+
+            void emit_fan(vec2 center, vec2 from, float angle, float resolution, vec4 reference, vec4 color) {
+                int   num_segments = clamp(int(ceil(abs(angle) / resolution)), 1, MAX_ROUND_SEGMENTS);
+                float angle_step   = angle / float(num_segments);
+                for (int i = 0; i < num_segments; ++i) {
+                    emit_triangle(center,
+                                  center + rotate(from, angle_step * float(i)),
+                                  center + rotate(from, angle_step * float(i + 1)),
+                                  reference, color);
+                }
+            }
+
+            void emit_cap(vec2 p, vec2 direction, vec2 normal, float half_width, int cap, vec4 reference, vec4 color) {
+                // NOTE `direction` points away from the line
+                vec2 n = normal * half_width;
+                vec2 d = direction * half_width;
+                if (cap == CAP_PROJECT) {
+                    emit(p + n, reference, color);
+                    emit(p - n, reference, color);
+                    emit(p + n + d, reference, color);
+                    emit(p - n + d, reference, color);
+                    EndPrimitive();
+                } else if (cap == CAP_POINTED) {
+                    emit_triangle(p + n, p - n, p + d, reference, color);
+                } else if (cap == CAP_ROUND) {
+                    float side = sign(direction.x * n.y - direction.y * n.x);
+                    emit_fan(p, n, -side * 3.14159265, uCapRoundResolution, reference, color);
+                }
+            }
+
+            void main() {
+                vec4 clip_start = gl_in[1].gl_Position;
+                vec4 clip_end   = gl_in[2].gl_Position;
+                if (clip_start.w <= 0.0 || clip_end.w <= 0.0) {
+                    return; // NOTE segments crossing the camera plane are skipped
+                }
+
+                vec2  p_start        = to_screen(clip_start);
+                vec2  p_end          = to_screen(clip_end);
+                vec2  direction      = p_end - p_start;
+                float segment_length = length(direction);
+                if (segment_length < EPSILON) {
+                    return;
+                }
+                direction /= segment_length;
+                vec2 normal = vec2(-direction.y, direction.x);
+
+                float half_width  = gs_in[1].stroke.x * 0.5;
+                int   mode        = int(gs_in[1].stroke.y + 0.5);
+                int   join        = mode / 4;
+                int   cap         = mode - join * 4;
+                bool  has_prev    = gs_in[0].stroke.y >= 0.0;
+                bool  has_next    = gs_in[3].stroke.y >= 0.0;
+                vec4  color_start = gs_in[1].color;
+                vec4  color_end   = gs_in[2].color;
+
+                /* segment body */
+                vec2 n = normal * half_width;
+                emit(p_start + n, clip_start, color_start);
+                emit(p_start - n, clip_start, color_start);
+                emit(p_end + n, clip_end, color_end);
+                emit(p_end - n, clip_end, color_end);
+                EndPrimitive();
+
+                /* caps */
+                if (!has_prev) {
+                    emit_cap(p_start, -direction, normal, half_width, cap, clip_start, color_start);
+                }
+                if (!has_next) {
+                    emit_cap(p_end, direction, normal, half_width, cap, clip_end, color_end);
+                    return;
+                }
+
+                /* join at end of segment */
+                if (gl_in[3].gl_Position.w <= 0.0) {
+                    return;
+                }
+                vec2  next_direction = to_screen(gl_in[3].gl_Position) - p_end;
+                float next_length    = length(next_direction);
+                if (next_length < EPSILON) {
+                    return;
+                }
+                next_direction /= next_length;
+                float turn  = direction.x * next_direction.y - direction.y * next_direction.x;
+                float angle = atan(turn, dot(direction, next_direction));
+                if (abs(angle) < EPSILON) {
+                    return;
+                }
+                float side        = angle > 0.0 ? -1.0 : 1.0; // NOTE outer side of the turn
+                vec2  next_normal = vec2(-next_direction.y, next_direction.x);
+                vec2  a           = p_end + side * normal * half_width;
+                vec2  b           = p_end + side * next_normal * half_width;
+                if (join == JOIN_ROUND) {
+                    emit_fan(p_end, side * normal * half_width, angle, uJoinRoundResolution, clip_end, color_end);
+                } else if (join == JOIN_MITER && abs(angle) < uMiterMaxAngle) {
+                    vec2 miter = p_end + side * normalize(normal + next_normal) * half_width / cos(angle * 0.5);
+                    emit_triangle(p_end, a, miter, clip_end, color_end);
+                    emit_triangle(p_end, miter, b, clip_end, color_end);
+                } else if (join == JOIN_BEVEL || join == JOIN_MITER) {
+                    emit_triangle(p_end, a, b, clip_end, color_end);
+                }
+            }
+        )"};
+} // namespace umfeld
@@ -0,0 +1,490 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include "MovieRecorder.h"
+#include "PGraphics.h"
+#include "UmfeldFunctionsAdditional.h"
+
+using namespace umfeld;
+
+#if !defined(DISABLE_GRAPHICS) && !defined(DISABLE_VIDEO)
+
+extern "C" {
+#include <libavutil/channel_layout.h>
+#include <libavutil/opt.h>
+}
+
+MovieRecorder::MovieRecorder(const std::string& filename,
+                             const int          width,
+                             const int          height,
+                             const float        frame_rate,
+                             const Codec        codec,
+                             const int          audio_channels,
+                             const int          audio_sample_rate,
+                             const size_t       max_queued_frames)
+    : filename(filename),
+      width(width),
+      height(height),
+      frame_rate(frame_rate),
+      codec(codec),
+      audio_channels(audio_channels),
+      audio_sample_rate(audio_sample_rate),
+      max_queued_frames(std::max<size_t>(max_queued_frames, 1)) {}
+
+MovieRecorder::~MovieRecorder() {
+    finish();
+}
+
+bool MovieRecorder::start() {
+    if (recording) {
+        return true;
+    }
+    if (width <= 0 || height <= 0 || frame_rate <= 0) {
+        error("MovieRecorder: invalid size or frame rate");
+        return false;
+    }
+    if (!open()) {
+        close();
+        return false;
+    }
+    if (audio_codec_context != nullptr) {
+        // NOTE the queue is kept until the recorder is destroyed as the audio thread might still access it
+        if (audio_queue == nullptr) {
+            audio_queue = std::make_unique<SPSCQueue<float, AUDIO_QUEUE_CAPACITY>>();
+        }
+        float sample;
+        while (audio_queue->pop(sample)) {} // NOTE discard samples from a previous recording
+    }
+    num_audio_frames_dropped = 0;
+    stopping                 = false;
+    recording                = true;
+    encoder_thread           = std::thread(&MovieRecorder::encoder_loop, this);
+    return true;
+}
+
+bool MovieRecorder::add_frame(PGraphics* graphics) {
+    if (!recording || graphics == nullptr) {
+        return false;
+    }
+    readback_graphics = graphics;
+    // NOTE OpenGL rows are bottom-up
+    return graphics->read_framebuffer_async([this](std::vector<unsigned char>& pixels, const int frame_width, const int frame_height) {
+        queue_frame(std::move(pixels), frame_width, frame_height, true);
+    });
+}
+
+bool MovieRecorder::add_frame(std::vector<unsigned char>&& pixels, const bool flip_vertically) {
+    return queue_frame(std::move(pixels), width, height, flip_vertically);
+}
+
+bool MovieRecorder::queue_frame(std::vector<unsigned char>&& pixels, const int frame_width, const int frame_height, const bool flip_vertically) {
+    if (!recording) {
+        return false;
+    }
+    if (frame_width <= 0 || frame_height <= 0 || pixels.size() < static_cast<size_t>(frame_width) * frame_height * 4) {
+        warning("MovieRecorder: frame data too small. frame is skipped.");
+        return false;
+    }
+    {
+        std::unique_lock lock(mutex);
+        frame_taken.wait(lock, [this] { return video_frames.size() < max_queued_frames; });
+        video_frames.push_back({std::move(pixels), frame_width, frame_height, flip_vertically});
+        num_frames_added++;
+    }
+    work_available.notify_one();
+    return true;
+}
+
+void MovieRecorder::add_audio(const float* samples, const int num_frames) {
+    if (!recording || audio_queue == nullptr || samples == nullptr || num_frames <= 0) {
+        return;
+    }
+    // NOTE the encoder thread drains the queue at least every `AUDIO_DRAIN_INTERVAL` milliseconds
+    if (!audio_queue->push(samples, static_cast<size_t>(num_frames) * audio_channels)) {
+        num_audio_frames_dropped += num_frames;
+    }
+}
+
+void MovieRecorder::finish() {
+    if (!recording) {
+        return;
+    }
+    if (readback_graphics != nullptr) {
+        readback_graphics->finish_framebuffer_readbacks(); // NOTE pending readbacks still add frames
+        readback_graphics = nullptr;
+    }
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_one();
+    if (encoder_thread.joinable()) {
+        encoder_thread.join();
+    }
+    recording = false;
+    close();
+    if (num_audio_frames_dropped > 0) {
+        warning("MovieRecorder: encoder fell behind, dropped ", num_audio_frames_dropped.load(), " audio frames");
+    }
+    console("MovieRecorder: wrote ", num_frames_added, " frames to ", filename);
+}
+
+void MovieRecorder::encoder_loop() {
+    while (true) {
+        VideoFrame frame;
+        bool       has_frame = false;
+        {
+            std::unique_lock lock(mutex);
+            // NOTE the audio thread does not notify, queued audio is picked up after a timeout
+            work_available.wait_for(lock, std::chrono::milliseconds(AUDIO_DRAIN_INTERVAL), [this] {
+                return stopping || !video_frames.empty();
+            });
+            if (!video_frames.empty()) {
+                frame = std::move(video_frames.front());
+                video_frames.pop_front();
+                has_frame = true;
+            }
+            if (!has_frame && stopping) {
+                break;
+            }
+        }
+        if (has_frame) {
+            frame_taken.notify_one();
+        }
+        drain_audio();
+        if (has_frame) {
+            encode_video(frame);
+        }
+    }
+
+    /* flush encoders */
+    drain_audio();
+    encode_audio(true);
+    if (audio_codec_context != nullptr) {
+        avcodec_send_frame(audio_codec_context, nullptr);
+        write_packets(audio_codec_context, audio_stream);
+    }
+    avcodec_send_frame(video_codec_context, nullptr);
+    write_packets(video_codec_context, video_stream);
+    av_write_trailer(format_context);
+}
+
+bool MovieRecorder::open() {
+    avformat_alloc_output_context2(&format_context, nullptr, nullptr, filename.c_str());
+    if (format_context == nullptr) {
+        error("MovieRecorder: could not derive container format from ", filename);
+        return false;
+    }
+    if (!open_video_stream()) {
+        return false;
+    }
+    if (audio_channels > 0 && audio_sample_rate > 0 && !open_audio_stream()) {
+        return false;
+    }
+    if (!(format_context->oformat->flags & AVFMT_NOFILE)) {
+        if (avio_open(&format_context->pb, filename.c_str(), AVIO_FLAG_WRITE) < 0) {
+            error("MovieRecorder: could not open file ", filename);
+            return false;
+        }
+    }
+    if (avformat_write_header(format_context, nullptr) < 0) {
+        error("MovieRecorder: could not write header to ", filename);
+        return false;
+    }
+    packet = av_packet_alloc();
+    return packet != nullptr;
+}
+
+bool MovieRecorder::open_video_stream() {
+    const AVCodec* encoder      = nullptr;
+    AVPixelFormat  pixel_format = AV_PIX_FMT_YUV420P;
+    switch (codec) {
+        case PRORES:
+            encoder      = avcodec_find_encoder_by_name("prores_ks");
+            pixel_format = AV_PIX_FMT_YUV422P10LE;
+            break;
+        case FFV1:
+            encoder      = avcodec_find_encoder(AV_CODEC_ID_FFV1);
+            pixel_format = AV_PIX_FMT_BGR0; // NOTE lossless RGB
+            break;
+        case H264:
+        default:
+            encoder      = avcodec_find_encoder_by_name("libx264");
+            pixel_format = AV_PIX_FMT_YUV420P;
+            if (encoder == nullptr) {
+                encoder = avcodec_find_encoder(AV_CODEC_ID_H264);
+            }
+            break;
+    }
+    if (encoder == nullptr) {
+        error("MovieRecorder: video encoder not available");
+        return false;
+    }
+
+    video_codec_context = avcodec_alloc_context3(encoder);
+    if (video_codec_context == nullptr) {
+        return false;
+    }
+    const AVRational rate             = av_d2q(frame_rate, 100000);
+    video_codec_context->width        = pixel_format == AV_PIX_FMT_YUV420P ? width & ~1 : width; // NOTE 4:2:0 requires even dimensions
+    video_codec_context->height       = pixel_format == AV_PIX_FMT_YUV420P ? height & ~1 : height;
+    video_codec_context->time_base    = av_inv_q(rate);
+    video_codec_context->framerate    = rate;
+    video_codec_context->pix_fmt      = pixel_format;
+    video_codec_context->gop_size     = 12;
+    video_codec_context->thread_count = 0; // NOTE let the encoder decide
+    if (codec == H264) {
+        av_opt_set(video_codec_context->priv_data, "preset", "medium", 0);
+        av_opt_set(video_codec_context->priv_data, "crf", "18", 0);
+    }
+    if (format_context->oformat->flags & AVFMT_GLOBALHEADER) {
+        video_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    if (avcodec_open2(video_codec_context, encoder, nullptr) < 0) {
+        error("MovieRecorder: could not open video encoder ", encoder->name);
+        return false;
+    }
+
+    video_stream = avformat_new_stream(format_context, nullptr);
+    if (video_stream == nullptr) {
+        return false;
+    }
+    video_stream->time_base = video_codec_context->time_base;
+    avcodec_parameters_from_context(video_stream->codecpar, video_codec_context);
+
+    video_frame         = av_frame_alloc();
+    video_frame->format = video_codec_context->pix_fmt;
+    video_frame->width  = video_codec_context->width;
+    video_frame->height = video_codec_context->height;
+    if (av_frame_get_buffer(video_frame, 0) < 0) {
+        error("MovieRecorder: could not allocate video frame");
+        return false;
+    }
+    return true;
+}
+
+bool MovieRecorder::open_audio_stream() {
+    // NOTE MP4 does not support PCM, AAC is used with H.264
+    const bool     use_aac = codec == H264;
+    const AVCodec* encoder = avcodec_find_encoder(use_aac ? AV_CODEC_ID_AAC : AV_CODEC_ID_PCM_S16LE);
+    if (encoder == nullptr) {
+        error("MovieRecorder: audio encoder not available");
+        return false;
+    }
+    audio_codec_context = avcodec_alloc_context3(encoder);
+    if (audio_codec_context == nullptr) {
+        return false;
+    }
+    audio_codec_context->sample_fmt  = use_aac ? AV_SAMPLE_FMT_FLTP : AV_SAMPLE_FMT_S16;
+    audio_codec_context->sample_rate = audio_sample_rate;
+    audio_codec_context->time_base   = {1, audio_sample_rate};
+    audio_codec_context->bit_rate    = use_aac ? 192000 : 0;
+    av_channel_layout_default(&audio_codec_context->ch_layout, audio_channels);
+    if (format_context->oformat->flags & AVFMT_GLOBALHEADER) {
+        audio_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    if (avcodec_open2(audio_codec_context, encoder, nullptr) < 0) {
+        error("MovieRecorder: could not open audio encoder ", encoder->name);
+        return false;
+    }
+
+    audio_stream = avformat_new_stream(format_context, nullptr);
+    if (audio_stream == nullptr) {
+        return false;
+    }
+    audio_stream->time_base = audio_codec_context->time_base;
+    avcodec_parameters_from_context(audio_stream->codecpar, audio_codec_context);
+
+    audio_frame              = av_frame_alloc();
+    audio_frame->format      = audio_codec_context->sample_fmt;
+    audio_frame->sample_rate = audio_sample_rate;
+    audio_frame->nb_samples  = audio_codec_context->frame_size > 0 ? audio_codec_context->frame_size : 1024; // NOTE PCM has no fixed frame size
+    av_channel_layout_copy(&audio_frame->ch_layout, &audio_codec_context->ch_layout);
+    if (av_frame_get_buffer(audio_frame, 0) < 0) {
+        error("MovieRecorder: could not allocate audio frame");
+        return false;
+    }
+    return true;
+}
+
+void MovieRecorder::close() {
+    if (format_context != nullptr && !(format_context->oformat->flags & AVFMT_NOFILE)) {
+        avio_closep(&format_context->pb);
+    }
+    avcodec_free_context(&video_codec_context);
+    avcodec_free_context(&audio_codec_context);
+    av_frame_free(&video_frame);
+    av_frame_free(&audio_frame);
+    av_packet_free(&packet);
+    sws_freeContext(sws_context);
+    sws_context = nullptr;
+    avformat_free_context(format_context);
+    format_context = nullptr;
+    video_stream   = nullptr;
+    audio_stream   = nullptr;
+    video_pts      = 0;
+    audio_pts      = 0;
+    audio_pending.clear();
+}
+
+void MovieRecorder::encode_video(const VideoFrame& frame) {
+    sws_context = sws_getCachedContext(sws_context,
+                                       frame.width, frame.height, AV_PIX_FMT_RGBA,
+                                       video_frame->width, video_frame->height, static_cast<AVPixelFormat>(video_frame->format),
+                                       SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (sws_context == nullptr || av_frame_make_writable(video_frame) < 0) {
+        warning("MovieRecorder: could not convert frame");
+        return;
+    }
+    // NOTE rows are flipped by starting at the last row with a negative stride
+    const int            row_size      = frame.width * 4;
+    const uint8_t* const src_data[1]   = {frame.pixels.data() + (frame.flip_vertically ? (frame.height - 1) * row_size : 0)};
+    const int            src_stride[1] = {frame.flip_vertically ? -row_size : row_size};
+    sws_scale(sws_context, src_data, src_stride, 0, frame.height, video_frame->data, video_frame->linesize);
+    video_frame->pts = video_pts++;
+    if (avcodec_send_frame(video_codec_context, video_frame) < 0) {
+        warning("MovieRecorder: could not encode frame");
+        return;
+    }
+    write_packets(video_codec_context, video_stream);
+}
+
+/**
+ * moves all samples queued by `add_audio` to `audio_pending` and encodes them
+ */
+void MovieRecorder::drain_audio() {
+    if (audio_queue == nullptr || audio_queue->empty()) {
+        return;
+    }
+    const size_t offset = audio_pending.size();
+    audio_pending.resize(offset + audio_queue->size());
+    audio_pending.resize(offset + audio_queue->pop(audio_pending.data() + offset, audio_pending.size() - offset));
+    encode_audio(false);
+}
+
+/**
+ * encodes complete audio frames from `audio_pending`. with `flush` the remaining samples are
+ * encoded as a last, shorter frame.
+ */
+void MovieRecorder::encode_audio(const bool flush) {
+    if (audio_codec_context == nullptr) {
+        audio_pending.clear();
+        return;
+    }
+    const int frame_size = audio_frame->nb_samples;
+    size_t    offset     = 0;
+    while (true) {
+        const int available = static_cast<int>((audio_pending.size() - offset) / audio_channels);
+        if (available <= 0 || (available < frame_size && !flush)) {
+            break;
+        }
+        const int num_samples = std::min(available, frame_size);
+        if (av_frame_make_writable(audio_frame) < 0) {
+            break;
+        }
+        audio_frame->nb_samples = num_samples;
+        const float* samples    = audio_pending.data() + offset;
+        if (audio_codec_context->sample_fmt == AV_SAMPLE_FMT_FLTP) {
+            for (int c = 0; c < audio_channels; ++c) {
+                auto* channel = reinterpret_cast<float*>(audio_frame->data[c]);
+                for (int i = 0; i < num_samples; ++i) {
+                    channel[i] = samples[i * audio_channels + c];
+                }
+            }
+        } else {
+            auto* interleaved = reinterpret_cast<int16_t*>(audio_frame->data[0]);
+            for (int i = 0; i < num_samples * audio_channels; ++i) {
+                interleaved[i] = static_cast<int16_t>(std::clamp(samples[i], -1.0f, 1.0f) * 32767.0f);
+            }
+        }
+        audio_frame->pts = audio_pts;
+        audio_pts += num_samples;
+        offset += static_cast<size_t>(num_samples) * audio_channels;
+        if (avcodec_send_frame(audio_codec_context, audio_frame) >= 0) {
+            write_packets(audio_codec_context, audio_stream);
+        }
+        audio_frame->nb_samples = frame_size;
+    }
+    audio_pending.erase(audio_pending.begin(), audio_pending.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+bool MovieRecorder::write_packets(AVCodecContext* codec_context, const AVStream* stream) {
+    while (true) {
+        const int result = avcodec_receive_packet(codec_context, packet);
+        if (result == AVERROR(EAGAIN) || result == AVERROR_EOF) {
+            return true;
+        }
+        if (result < 0) {
+            warning("MovieRecorder: error while encoding");
+            return false;
+        }
+        av_packet_rescale_ts(packet, codec_context->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        if (av_interleaved_write_frame(format_context, packet) < 0) { // NOTE takes ownership of the packet data
+            warning("MovieRecorder: could not write packet");
+            return false;
+        }
+    }
+}
+
+#else
+MovieRecorder::MovieRecorder(const std::string& filename,
+                             const int          width,
+                             const int          height,
+                             const float        frame_rate,
+                             const Codec        codec,
+                             const int          audio_channels,
+                             const int          audio_sample_rate,
+                             const size_t       max_queued_frames)
+    : filename(filename),
+      width(width),
+      height(height),
+      frame_rate(frame_rate),
+      codec(codec),
+      audio_channels(audio_channels),
+      audio_sample_rate(audio_sample_rate),
+      max_queued_frames(max_queued_frames) {}
+
+MovieRecorder::~MovieRecorder() {}
+
+bool MovieRecorder::start() {
+    error("MovieRecorder - ERROR: video is disabled");
+    return false;
+}
+
+bool MovieRecorder::add_frame(PGraphics* graphics) { return false; }
+
+bool MovieRecorder::add_frame(std::vector<unsigned char>&& pixels, bool flip_vertically) { return false; }
+
+void MovieRecorder::add_audio(const float* samples, int num_frames) {}
+
+void MovieRecorder::finish() {}
+
+bool MovieRecorder::queue_frame(std::vector<unsigned char>&& pixels, int frame_width, int frame_height, bool flip_vertically) { return false; }
+
+bool MovieRecorder::open() { return false; }
+
+void MovieRecorder::close() {}
+
+void MovieRecorder::encoder_loop() {}
+
+#endif // DISABLE_GRAPHICS && DISABLE_VIDEO
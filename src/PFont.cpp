@@ -29,29 +29,11 @@ using namespace umfeld;
 
 #ifdef PFONT_DEBUG_FONT
 void PFont::DEBUG_save_font_atlas(const FontData& font, const std::string& output_path) const {
-    // Convert the grayscale atlas to an RGBA image for better visibility
-    std::vector<unsigned char> atlas_rgba(font.atlas_width * font.atlas_height * 4, 255);
-    for (int y = 0; y < font.atlas_height; y++) {
-        for (int x = 0; x < font.atlas_width; x++) {
-            const unsigned char val = font.atlas[y * font.atlas_width + x];
-            const int           idx = (y * font.atlas_width + x) * 4;
-
-            // Store grayscale value into RGBA format (transparent text on white fond)
-            atlas_rgba[idx + 0] = 255; // R
-            atlas_rgba[idx + 1] = 255; // G
-            atlas_rgba[idx + 2] = 255; // B
-            atlas_rgba[idx + 3] = val; // A (fully opaque)
-
-            // // Store grayscale value into RGBA format (white text on black background)
-            // atlas_rgba[idx + 0] = val; // R
-            // atlas_rgba[idx + 1] = val; // G
-            // atlas_rgba[idx + 2] = val; // B
-            // atlas_rgba[idx + 3] = 255; // A (fully opaque)
-        }
+    // NOTE atlas pages are stored as RGBA already ( transparent text on white fond )
+    for (size_t i = 0; i < font.pages.size(); ++i) {
+        const std::string page_path = i == 0 ? output_path : output_path + "." + std::to_string(i) + ".png";
+        stbi_write_png(page_path.c_str(), font.page_size, font.page_size, 4, font.pages[i].image->pixels, font.page_size * 4);
     }
-
-    // Save as PNG
-    stbi_write_png(output_path.c_str(), font.atlas_width, font.atlas_height, 4, atlas_rgba.data(), font.atlas_width * 4);
     console("Font atlas saved to: ", output_path);
 }
 
@@ -79,7 +61,7 @@ void PFont::DEBUG_save_text(const FontData&    font,
     // Compute max width while ignoring missing glyphs
     for (unsigned int i = 0; i < glyph_count; i++) {
         uint32_t glyph_id = glyph_info[i].codepoint;
-        if (glyph_id == ' ' || font.glyphs.find(glyph_id) != font.glyphs.end()) {
+        if (font.glyphs.find(glyph_id) != font.glyphs.end()) {
             trimmed_advance += glyph_pos[i].x_advance >> 6; // Count only valid glyphs and spaces
         }
         total_advance += glyph_pos[i].x_advance >> 6; // Original width
@@ -98,13 +80,15 @@ void PFont::DEBUG_save_text(const FontData&    font,
 
         auto it = font.glyphs.find(glyph_id);
         if (it == font.glyphs.end()) {
-            if (glyph_id == ' ') {
-                x += glyph_pos[i].x_advance >> 6; // Move forward for spaces
-            }
             continue;
         }
 
         const Glyph& g = it->second;
+        if (g.page == NO_PAGE) {
+            x += glyph_pos[i].x_advance >> 6; // Move forward for spaces
+            continue;
+        }
+        const auto* page_bytes = reinterpret_cast<const unsigned char*>(font.pages[g.page].image->pixels);
 
         const int x_pos = x + g.left + (glyph_pos[i].x_offset >> 6);
         const int y_pos = y - g.top + (glyph_pos[i].y_offset >> 6);
@@ -117,9 +101,9 @@ void PFont::DEBUG_save_text(const FontData&    font,
                 const int img_y   = y_pos + row;
 
                 if (img_x >= 0 && img_x < total_advance && img_y >= 0 && img_y < max_height) {
-                    if (atlas_x >= 0 && atlas_x < font.atlas_width &&
-                        atlas_y >= 0 && atlas_y < font.atlas_height) {
-                        unsigned char val                    = font.atlas[atlas_y * font.atlas_width + atlas_x];
+                    if (atlas_x >= 0 && atlas_x < font.page_size &&
+                        atlas_y >= 0 && atlas_y < font.page_size) {
+                        unsigned char val                    = page_bytes[(atlas_y * font.page_size + atlas_x) * 4 + 3];
                         image[img_y * total_advance + img_x] = std::max(image[img_y * total_advance + img_x], val);
                     }
                 }
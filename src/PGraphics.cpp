@@ -20,6 +20,9 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -35,6 +38,7 @@
 #include "PGraphics.h"
 #include "Vertex.h"
 #include "Geometry.h"
+#include "WorkerPool.h"
 
 using namespace umfeld;
 
@@ -49,13 +53,49 @@ PGraphics::PGraphics() : PImage(0, 0, 0) {
 void PGraphics::beginDraw() {
     reset_mvp_matrices();
     blendMode(BLEND);
+    tessellation_cache.next_frame();
 }
 
 void PGraphics::endDraw() {
     restore_mvp_matrices();
 }
 
-void PGraphics::hint(const uint16_t property) {}
+/**
+ * reads the framebuffer and passes the pixels to `callback`. renderers that support asynchronous
+ * readback call `callback` a few frames later from the draw thread, this default implementation
+ * reads synchronously and calls `callback` immediately.
+ */
+bool PGraphics::read_framebuffer_async(const FramebufferReadbackCallback& callback) {
+    if (!callback) {
+        return false;
+    }
+    std::vector<unsigned char> pixels;
+    if (!read_framebuffer(pixels)) {
+        return false;
+    }
+    callback(pixels, framebuffer.width, framebuffer.height);
+    return true;
+}
+
+void PGraphics::hint(const uint16_t property) {
+    switch (property) {
+        case ENABLE_TESSELLATION_CACHE:
+            tessellation_cache_enabled = true;
+            break;
+        case DISABLE_TESSELLATION_CACHE:
+            tessellation_cache_enabled = false;
+            tessellation_cache.clear();
+            break;
+        case ENABLE_SIGNED_DISTANCE_FIELD_FONTS:
+            signed_distance_field_fonts = true;
+            break;
+        case DISABLE_SIGNED_DISTANCE_FIELD_FONTS:
+            signed_distance_field_fonts = false;
+            break;
+        default:
+            break;
+    }
+}
 
 void PGraphics::pixelDensity(const int density) {
     static bool emitted_warning = false;
@@ -631,7 +671,7 @@ PImage* PGraphics::loadImage(const std::string& filename) {
 }
 
 PFont* PGraphics::loadFont(const std::string& file, const float size) {
-    auto* font = new PFont(file, size); // TODO what about pixel_density … see FTGL implementation
+    auto* font = new PFont(file, size, 1, signed_distance_field_fonts); // TODO what about pixel_density … see FTGL implementation
     return font;
 }
 
@@ -693,7 +733,107 @@ void PGraphics::text_str(const std::string& text, const float x, const float y,
         return;
     }
 
-    current_font->draw(this, text, x, y, z);
+    if (!text_batching) {
+        current_font->draw(this, text, x, y, z);
+        return;
+    }
+
+    const PFont::GlyphRun& run = current_font->glyph_run(text);
+    if (run.vertices.empty()) {
+        return;
+    }
+    current_font->update_atlas(this); // NOTE uploads glyphs rasterized for this run ( if any )
+
+    // NOTE transform to world space here so that text drawn with different transforms ends up in the same batch
+    const float     scale = current_font->text_scale();
+    const glm::vec4 color = as_vec4(color_fill);
+    for (const auto& range: run.page_ranges) {
+        std::vector<Vertex>& batch_vertices = text_batch(current_font->atlas_page(range.page), current_font->is_signed_distance_field());
+        const size_t         start          = batch_vertices.size();
+        batch_vertices.resize(start + range.count);
+        for (size_t i = 0; i < range.count; ++i) {
+            const glm::vec4& v = run.vertices[range.first + i];
+            Vertex&          t = batch_vertices[start + i];
+            t.position         = model_matrix * glm::vec4(x + v.x * scale, y + v.y * scale, z, 1.0f);
+            t.normal           = current_normal;
+            t.color            = color;
+            t.tex_coord        = glm::vec2(v.z, v.w);
+        }
+    }
+}
+
+/**
+ * @return vertices of the last batch if it uses `texture` or of a new batch otherwise. batches are only
+ *         appended ( never merged with earlier ones ) so that overlapping text keeps its drawing order.
+ */
+std::vector<Vertex>& PGraphics::text_batch(PImage* texture, const bool signed_distance_field) {
+    // NOTE batches in use are a prefix of `text_batches`, empty batches after it are reused
+    size_t num_used_batches = 0;
+    while (num_used_batches < text_batches.size() && !text_batches[num_used_batches].vertices.empty()) {
+        num_used_batches++;
+    }
+    if (num_used_batches > 0) {
+        TextBatch& last_batch = text_batches[num_used_batches - 1];
+        if (last_batch.texture == texture && last_batch.signed_distance_field == signed_distance_field) {
+            return last_batch.vertices;
+        }
+    }
+    if (num_used_batches == text_batches.size()) {
+        text_batches.emplace_back();
+    }
+    TextBatch& batch            = text_batches[num_used_batches];
+    batch.texture               = texture;
+    batch.signed_distance_field = signed_distance_field;
+    return batch.vertices;
+}
+
+/**
+ * emits all text collected by `text_str()` with one batch per run of text sharing a font atlas page. needs to be called
+ * before any other geometry is emitted to preserve drawing order.
+ */
+void PGraphics::text_flush() {
+    if (text_batch_flushing) {
+        return;
+    }
+
+    // NOTE flush may be triggered from within `endShape()` where `texture()` is not allowed
+    const glm::mat4 tmp_model_matrix       = model_matrix;
+    const bool      tmp_model_matrix_dirty = model_matrix_dirty;
+    const bool      tmp_shape_has_begun    = shape_has_begun;
+    const int       tmp_bound_texture      = texture_id_current;
+    bool            emitted                = false;
+    text_batch_flushing                    = true;
+    for (auto& batch: text_batches) {
+        if (batch.vertices.empty()) {
+            continue;
+        }
+        if (!emitted) {
+            model_matrix       = glm::mat4(1.0f);
+            model_matrix_dirty = false;
+            shape_has_begun    = false;
+            emitted            = true;
+        }
+        IMPL_set_texture(batch.texture); // NOTE creates texture on first use
+        if (batch.signed_distance_field) {
+            emit_text_signed_distance_field(batch.vertices);
+        } else {
+            emit_shape_fill_triangles(batch.vertices);
+        }
+        batch.vertices.clear();
+    }
+    text_batch_flushing = false;
+    if (emitted) {
+        model_matrix       = tmp_model_matrix;
+        model_matrix_dirty = tmp_model_matrix_dirty;
+        shape_has_begun    = tmp_shape_has_begun;
+        IMPL_bind_texture(tmp_bound_texture);
+    }
+}
+
+void PGraphics::text_discard() {
+    for (auto& batch: text_batches) {
+        batch.vertices.clear();
+    }
 }
 
 void PGraphics::texture(PImage* img) {
@@ -810,6 +950,225 @@ void PGraphics::sphere(const float width, const float height, const float depth)
     endShape();
 }
 
+/* --- depth sorted translucent triangles --- */
+
+bool PGraphics::has_translucent_vertices(const std::vector<Vertex>& vertices) {
+    for (const auto& v: vertices) {
+        if (v.color.a < 1.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * collects triangles in world space ( together with the currently bound texture ) to be sorted and
+ * emitted in `translucent_flush()`.
+ * @param triangle_vertices
+ */
+void PGraphics::translucent_enqueue(const std::vector<Vertex>& triangle_vertices) {
+    const size_t num_triangles = triangle_vertices.size() / 3;
+    if (num_triangles == 0) {
+        return;
+    }
+    const size_t start_index = translucent_vertices.size();
+    translucent_vertices.insert(translucent_vertices.end(), triangle_vertices.begin(), triangle_vertices.begin() + num_triangles * 3);
+    if (model_matrix_dirty) {
+        for (auto it = translucent_vertices.begin() + start_index; it != translucent_vertices.end(); ++it) {
+            it->position = glm::vec4(model_matrix * it->position);
+        }
+    }
+    translucent_texture_ids.insert(translucent_texture_ids.end(), num_triangles, texture_id_current);
+}
+
+/**
+ * sorts collected triangles back-to-front by view depth and emits them. depth is quantized to 24 bit
+ * relative to the depth range of the collected triangles and sorted with a ( multi-threaded ) radix
+ * sort. triangles are emitted in runs of the same texture.
+ */
+void PGraphics::translucent_flush() {
+    const size_t num_triangles = translucent_texture_ids.size();
+    if (num_triangles == 0 || !depth_sort_translucent) { // NOTE flag is cleared while emitting to prevent re-entry
+        return;
+    }
+
+    static constexpr int      DEPTH_KEY_BITS = 24;
+    static constexpr uint32_t DEPTH_KEY_MAX  = (1u << DEPTH_KEY_BITS) - 1;
+
+    translucent_depths.resize(num_triangles);
+    translucent_sort_keys.resize(num_triangles);
+    translucent_sort_indices.resize(num_triangles);
+    float min_depth = std::numeric_limits<float>::max();
+    float max_depth = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < num_triangles; ++i) {
+        const glm::vec4 centroid = (translucent_vertices[i * 3 + 0].position +
+                                    translucent_vertices[i * 3 + 1].position +
+                                    translucent_vertices[i * 3 + 2].position) /
+                                   3.0f;
+        const float depth = -(view_matrix * centroid).z; // NOTE camera looks down negative z
+        min_depth                   = std::min(min_depth, depth);
+        max_depth                   = std::max(max_depth, depth);
+        translucent_depths[i]       = depth;
+        translucent_sort_indices[i] = static_cast<uint32_t>(i);
+    }
+    const float depth_scale = max_depth > min_depth ? static_cast<float>(DEPTH_KEY_MAX) / (max_depth - min_depth) : 0.0f;
+    for (size_t i = 0; i < num_triangles; ++i) {
+        // NOTE float rounding may quantize the farthest depth to `DEPTH_KEY_MAX + 1` which would wrap the key
+        const uint32_t quantized_depth = std::min<uint32_t>(static_cast<uint32_t>((translucent_depths[i] - min_depth) * depth_scale), DEPTH_KEY_MAX);
+        translucent_sort_keys[i]       = DEPTH_KEY_MAX - quantized_depth; // NOTE farthest first
+    }
+    radix_sort(translucent_sort_keys, translucent_sort_indices, scratch_sort_keys, scratch_sort_indices, DEPTH_KEY_BITS);
+
+    // NOTE emit in world space i.e without model transform and without collecting again
+    const glm::mat4 tmp_model_matrix       = model_matrix;
+    const bool      tmp_model_matrix_dirty = model_matrix_dirty;
+    const int       tmp_bound_texture      = texture_id_current;
+    model_matrix                           = glm::mat4(1.0f);
+    model_matrix_dirty                     = false;
+    depth_sort_translucent                 = false;
+
+    scratch_translucent_vertices.clear();
+    int run_texture_id = translucent_texture_ids[translucent_sort_indices[0]];
+    for (size_t i = 0; i <= num_triangles; ++i) {
+        const bool end_of_queue = i == num_triangles;
+        const int  texture_id   = end_of_queue ? run_texture_id : translucent_texture_ids[translucent_sort_indices[i]];
+        if (end_of_queue || texture_id != run_texture_id) {
+            IMPL_bind_texture(run_texture_id);
+            emit_shape_fill_triangles(scratch_translucent_vertices);
+            scratch_translucent_vertices.clear();
+            run_texture_id = texture_id;
+        }
+        if (!end_of_queue) {
+            const uint32_t triangle = translucent_sort_indices[i];
+            scratch_translucent_vertices.insert(scratch_translucent_vertices.end(),
+                                                translucent_vertices.begin() + triangle * 3,
+                                                translucent_vertices.begin() + triangle * 3 + 3);
+        }
+    }
+
+    depth_sort_translucent = true;
+    model_matrix           = tmp_model_matrix;
+    model_matrix_dirty     = tmp_model_matrix_dirty;
+    IMPL_bind_texture(tmp_bound_texture);
+    translucent_discard();
+}
+
+void PGraphics::translucent_discard() {
+    translucent_vertices.clear();
+    translucent_texture_ids.clear();
+}
+
+/* --- instancing --- */
+
+void PGraphics::beginInstances() {
+    if (instances_begun) {
+        warning("`beginInstances()` called again before `endInstances()` … discarding recorded instances");
+    }
+    instances.clear();
+    instances_begun = true;
+}
+
+void PGraphics::instance() {
+    instance(model_matrix, as_vec4(color_fill));
+}
+
+void PGraphics::instance(const glm::mat4& transform, const glm::vec4& color) {
+    if (!instances_begun) {
+        warning("`instance()` called outside of `beginInstances()` and `endInstances()`");
+        return;
+    }
+    instances.push_back({transform, color});
+}
+
+/**
+ * fallback for renderers without instancing support: draws the mesh once per instance. note that
+ * the per-instance color is ignored here.
+ * @param mesh_shape
+ */
+void PGraphics::endInstances(VertexBuffer* mesh_shape) {
+    instances_begun = false;
+    if (mesh_shape != nullptr) {
+        const glm::mat4 tmp_model_matrix = model_matrix;
+        for (const auto& i: instances) {
+            model_matrix       = i.model_matrix;
+            model_matrix_dirty = true;
+            mesh(mesh_shape);
+        }
+        model_matrix = tmp_model_matrix;
+    }
+    instances.clear();
+}
+
+/**
+ * fallback for renderers without instancing support: emits the shape once per instance.
+ * @param instance_shape
+ */
+void PGraphics::endInstances(const int instance_shape) {
+    instances_begun = false;
+    generate_instance_shape(instance_shape, scratch_instance_vertices);
+    if (!scratch_instance_vertices.empty()) {
+        const glm::mat4 tmp_model_matrix = model_matrix;
+        for (const auto& i: instances) {
+            model_matrix       = i.model_matrix;
+            model_matrix_dirty = true;
+            for (auto& v: scratch_instance_vertices) {
+                v.color = i.color;
+            }
+            emit_shape_fill_triangles(scratch_instance_vertices);
+        }
+        model_matrix = tmp_model_matrix;
+    }
+    instances.clear();
+}
+
+/**
+ * generates a shape with unit size centered at the origin as triangles. vertex colors are white
+ * so that they can be tinted by the instance color.
+ * @param instance_shape RECT, ELLIPSE, BOX or SPHERE
+ * @param vertices cleared and filled with triangles
+ */
+void PGraphics::generate_instance_shape(const int instance_shape, std::vector<Vertex>& vertices) const {
+    vertices.clear();
+    switch (instance_shape) {
+        case RECT: {
+            const Vertex v0{glm::vec3(-0.5f, -0.5f, 0.0f), Vertex::DEFAULT_COLOR, glm::vec2(0.0f, 0.0f)};
+            const Vertex v1{glm::vec3(0.5f, -0.5f, 0.0f), Vertex::DEFAULT_COLOR, glm::vec2(1.0f, 0.0f)};
+            const Vertex v2{glm::vec3(0.5f, 0.5f, 0.0f), Vertex::DEFAULT_COLOR, glm::vec2(1.0f, 1.0f)};
+            const Vertex v3{glm::vec3(-0.5f, 0.5f, 0.0f), Vertex::DEFAULT_COLOR, glm::vec2(0.0f, 1.0f)};
+            vertices.insert(vertices.end(), {v0, v1, v2, v0, v2, v3});
+        } break;
+        case ELLIPSE: {
+            if (ellipse_points_LUT.size() < 2) {
+                break;
+            }
+            vertices.reserve((ellipse_points_LUT.size() - 1) * 3);
+            const Vertex center{glm::vec3(0.0f), Vertex::DEFAULT_COLOR, glm::vec2(0.5f, 0.5f)};
+            for (size_t i = 0; i + 1 < ellipse_points_LUT.size(); ++i) {
+                const glm::vec2 p0 = ellipse_points_LUT[i] * 0.5f;
+                const glm::vec2 p1 = ellipse_points_LUT[i + 1] * 0.5f;
+                vertices.push_back(center);
+                vertices.emplace_back(glm::vec3(p0, 0.0f), Vertex::DEFAULT_COLOR, p0 + 0.5f);
+                vertices.emplace_back(glm::vec3(p1, 0.0f), Vertex::DEFAULT_COLOR, p1 + 0.5f);
+            }
+        } break;
+        case BOX:
+            vertices.reserve(box_vertices_LUT.size());
+            for (const auto& v: box_vertices_LUT) {
+                vertices.emplace_back(v);
+            }
+            break;
+        case SPHERE:
+            vertices.reserve(sphere_vertices_LUT.size());
+            for (const auto& v: sphere_vertices_LUT) {
+                vertices.emplace_back(v);
+            }
+            break;
+        default:
+            warning("unknown instance shape: ", instance_shape);
+            break;
+    }
+}
+
 void PGraphics::resize_ellipse_points_LUT() {
     if (ellipse_detail < ELLIPSE_DETAIL_MIN) {
         return;
@@ -831,7 +1190,7 @@ void PGraphics::resize_ellipse_points_LUT() {
 
 // EARCUT
 
-std::vector<Vertex> PGraphics::triangulate_faster(const std::vector<Vertex>& vertices) {
+static std::vector<uint32_t> earcut_indices(const std::vector<Vertex>& vertices) {
     std::vector<std::vector<std::array<float, 2>>> polygon;
     polygon.emplace_back(); // Outer boundary
 
@@ -841,7 +1200,11 @@ std::vector<Vertex> PGraphics::triangulate_faster(const std::vector<Vertex>& ver
     }
 
     // perform triangulation
-    const std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon);
+    return mapbox::earcut<uint32_t>(polygon);
+}
+
+std::vector<Vertex> PGraphics::triangulate_faster(const std::vector<Vertex>& vertices) {
+    const std::vector<uint32_t> indices = earcut_indices(vertices);
     std::vector<Vertex>         triangleList;
 
     for (size_t i = 0; i < indices.size(); i++) {
@@ -877,8 +1240,14 @@ std::vector<TPPLPoly> convertToPolyPartition(const Clipper2Lib::PathsD& paths) {
     return polys;
 }
 
+static const Triangulator& thread_local_triangulator() {
+    // NOTE libtess2 tesselator keeps state, one per thread allows tessellating on worker threads
+    static thread_local const Triangulator triangulator{};
+    return triangulator;
+}
+
 std::vector<Vertex> PGraphics::triangulate_good(const std::vector<Vertex>& vertices) {
-    const std::vector<Vertex> triangles = triangulator.triangulate(vertices, Triangulator::Winding::WINDING_ODD);
+    const std::vector<Vertex> triangles = thread_local_triangulator().triangulate(vertices, Triangulator::Winding::WINDING_ODD);
     return triangles;
 }
 
@@ -995,11 +1364,13 @@ static glm::vec3 world_to_screen(
     return screen;
 }
 
-void PGraphics::triangulate_line_strip_vertex(const std::vector<Vertex>& line_strip, const bool close_shape, std::vector<Vertex>& line_vertices) const {
-    const glm::vec4        color  = line_strip[0].color;
-    const glm::vec4        normal = line_strip[0].normal;
-    std::vector<glm::vec2> points(line_strip.size());
-    std::vector<glm::vec2> triangles;
+void PGraphics::triangulate_line_strip_vertex(const std::vector<Vertex>& line_strip, const bool close_shape, std::vector<Vertex>& line_vertices) {
+    const glm::vec4         color     = line_strip[0].color;
+    const glm::vec4         normal    = line_strip[0].normal;
+    std::vector<glm::vec2>& points    = scratch_line_strip_points;
+    std::vector<glm::vec2>& triangles = scratch_line_strip_triangles;
+    points.resize(line_strip.size());
+    triangles.clear();
 
     const glm::mat4 mvp = projection_matrix * view_matrix * model_matrix;
     for (int i = 0; i < line_strip.size(); ++i) {
@@ -1008,16 +1379,29 @@ void PGraphics::triangulate_line_strip_vertex(const std::vector<Vertex>& line_st
         points[i] = world_to_screen(line_strip[i].position, mvp, width, height);
     }
 
-    triangulate_line_strip(points,
-                           close_shape,
-                           stroke_weight,
-                           stroke_join_mode,
-                           stroke_cap_mode,
-                           stroke_join_round_resolution,
-                           stroke_cap_round_resolution,
-                           stroke_join_miter_max_angle,
-                           triangles);
-    line_vertices.reserve(triangles.size());
+    // NOTE BEVEL, MITER and ROUND joins are tessellated without libtess2 unless the stroke self-intersects
+    bool tessellated = false;
+    if (StrokeTessellator::supports(stroke_join_mode)) {
+        stroke_tessellator.set_style(stroke_weight,
+                                     stroke_join_mode,
+                                     stroke_cap_mode,
+                                     stroke_join_round_resolution,
+                                     stroke_cap_round_resolution,
+                                     stroke_join_miter_max_angle);
+        tessellated = stroke_tessellator.tessellate(points, close_shape, triangles);
+    }
+    if (!tessellated) {
+        triangulate_line_strip(points,
+                               close_shape,
+                               stroke_weight,
+                               stroke_join_mode,
+                               stroke_cap_mode,
+                               stroke_join_round_resolution,
+                               stroke_cap_round_resolution,
+                               stroke_join_miter_max_angle,
+                               triangles);
+    }
+    line_vertices.reserve(line_vertices.size() + triangles.size());
     for (const auto& triangle: triangles) {
         line_vertices.emplace_back(glm::vec3(triangle, 0.0f), color, glm::vec2(0.0f, 0.0f), normal);
     }
@@ -1146,38 +1530,217 @@ void PGraphics::process_collected_fill_vertices() {
                 emit_shape_fill_triangles(shape_fill_vertex_buffer);
                 break;
             case TRIANGLE_FAN: {
-                std::vector<Vertex> vertices_fill_quads = convertTriangleFanToTriangles(shape_fill_vertex_buffer);
-                emit_shape_fill_triangles(vertices_fill_quads);
+                convertTriangleFanToTriangles(shape_fill_vertex_buffer, scratch_fill_triangles);
+                emit_shape_fill_triangles(scratch_fill_triangles);
             } break;
             case QUAD_STRIP: // NOTE does this just work?!?
             case TRIANGLE_STRIP: {
-                std::vector<Vertex> vertices_fill_quads = convertTriangleStripToTriangles(shape_fill_vertex_buffer);
-                emit_shape_fill_triangles(vertices_fill_quads);
+                convertTriangleStripToTriangles(shape_fill_vertex_buffer, scratch_fill_triangles);
+                emit_shape_fill_triangles(scratch_fill_triangles);
             } break;
             case QUADS: {
-                std::vector<Vertex> vertices_fill_quads = convertQuadsToTriangles(shape_fill_vertex_buffer);
-                emit_shape_fill_triangles(vertices_fill_quads);
+                convertQuadsToTriangles(shape_fill_vertex_buffer, scratch_fill_triangles);
+                emit_shape_fill_triangles(scratch_fill_triangles);
             } break;
             default:
             case POLYGON: {
-                std::vector<Vertex> vertices_fill_polygon;
-                if (polygon_triangulation_strategy == POLYGON_TRIANGULATION_FASTER) {
-                    // EARCUT :: supports concave polygons, textures but no holes or selfintersection
-                    vertices_fill_polygon = triangulate_faster(shape_fill_vertex_buffer);
-                } else if (polygon_triangulation_strategy == POLYGON_TRIANGULATION_BETTER) {
-                    // LIBTESS2 :: supports concave polygons, textures, holes and selfintersection but no textures
-                    vertices_fill_polygon = triangulate_good(shape_fill_vertex_buffer);
-                } else if (polygon_triangulation_strategy == POLYGON_TRIANGULATION_MID) {
-                    // POLYPARTITION + CLIPPER2 // TODO maybe remove this option
-                    vertices_fill_polygon = triangulate_better_quality(shape_fill_vertex_buffer);
-                }
-                emit_shape_fill_triangles(vertices_fill_polygon);
+                tessellate_polygon(shape_fill_vertex_buffer, scratch_fill_triangles);
+                emit_shape_fill_triangles(scratch_fill_triangles);
                 // TODO what if polygon has only 3 ( triangle ) or 4 vertices ( quad )? could shortcut … here
             } break;
         }
     }
 }
 
+std::vector<Vertex> PGraphics::triangulate(const std::vector<Vertex>& vertices, const int polygon_triangulation_strategy) {
+    TessellationCache::Triangles triangles;
+    triangulate(vertices, polygon_triangulation_strategy, triangles);
+    std::vector<Vertex> triangle_vertices;
+    TessellationCache::resolve(triangles, vertices, triangle_vertices);
+    return triangle_vertices;
+}
+
+/**
+ * assigns every triangle vertex the index of the outline vertex at the same position ( within
+ * `tolerance` ). vertices created by the triangulator ( e.g at self-intersections ) keep
+ * `NO_SOURCE_VERTEX`. outline vertices are binned into a grid so the lookup is linear.
+ * @param outline
+ * @param tolerance
+ * @param triangles
+ */
+static void find_source_vertices(const std::vector<Vertex>& outline, const float tolerance, TessellationCache::Triangles& triangles) {
+    static thread_local std::unordered_map<uint64_t, int32_t> grid;
+    const auto                                                cell_key = [](const int32_t x, const int32_t y) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+    };
+    const float cell_scale = 1.0f / tolerance;
+    grid.clear();
+    for (size_t i = 0; i < outline.size(); ++i) {
+        const auto x = static_cast<int32_t>(std::floor(outline[i].position.x * cell_scale));
+        const auto y = static_cast<int32_t>(std::floor(outline[i].position.y * cell_scale));
+        grid.emplace(cell_key(x, y), static_cast<int32_t>(i)); // NOTE keeps the first of coincident vertices
+    }
+    for (auto& t: triangles) {
+        const auto x             = static_cast<int32_t>(std::floor(t.position.x * cell_scale));
+        const auto y             = static_cast<int32_t>(std::floor(t.position.y * cell_scale));
+        float      best_distance = tolerance * tolerance;
+        t.source_index           = TessellationCache::NO_SOURCE_VERTEX;
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                const auto it = grid.find(cell_key(x + dx, y + dy));
+                if (it == grid.end()) {
+                    continue;
+                }
+                const glm::vec2 delta    = glm::vec2(t.position) - glm::vec2(outline[it->second].position);
+                const float     distance = glm::dot(delta, delta);
+                if (distance <= best_distance) {
+                    best_distance  = distance;
+                    t.source_index = it->second;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * triangulates a polygon outline into positions that reference the outline vertex they were created
+ * from. use `TessellationCache::resolve` to reconstruct vertices with attributes. all strategies
+ * keep the attributes of outline vertices, only new vertices take the attributes of the first one.
+ * @param vertices
+ * @param polygon_triangulation_strategy
+ * @param triangles
+ */
+void PGraphics::triangulate(const std::vector<Vertex>& vertices, const int polygon_triangulation_strategy, TessellationCache::Triangles& triangles) {
+    triangles.clear();
+    if (vertices.size() < 3) {
+        return;
+    }
+    if (polygon_triangulation_strategy == POLYGON_TRIANGULATION_FASTER) {
+        // EARCUT :: supports concave polygons, textures but no holes or selfintersection
+        for (const uint32_t index: earcut_indices(vertices)) {
+            triangles.push_back({glm::vec3(vertices[index].position), static_cast<int32_t>(index)});
+        }
+        return;
+    }
+    // NOTE libtess2 copies outline positions, Clipper2 rounds them to 2 decimal places
+    static constexpr float SOURCE_VERTEX_TOLERANCE = 0.01f;
+    std::vector<Vertex>    created;
+    if (polygon_triangulation_strategy == POLYGON_TRIANGULATION_BETTER) {
+        // LIBTESS2 :: supports concave polygons, textures, holes and selfintersection but no textures
+        created = triangulate_good(vertices);
+    } else if (polygon_triangulation_strategy == POLYGON_TRIANGULATION_MID) {
+        // POLYPARTITION + CLIPPER2 // TODO maybe remove this option
+        created = triangulate_better_quality(vertices);
+    } else {
+        return;
+    }
+    triangles.reserve(created.size());
+    for (const auto& v: created) {
+        triangles.push_back({glm::vec3(v.position), TessellationCache::NO_SOURCE_VERTEX});
+    }
+    find_source_vertices(vertices, SOURCE_VERTEX_TOLERANCE, triangles);
+}
+
+/**
+ * triangulates a polygon outline with the current triangulation strategy. unchanged outlines are
+ * looked up in the tessellation cache.
+ * @param outline
+ * @param triangle_vertices
+ */
+void PGraphics::tessellate_polygon(const std::vector<Vertex>& outline, std::vector<Vertex>& triangle_vertices) {
+    if (tessellation_cache_enabled) {
+        const uint64_t key = TessellationCache::hash(outline, polygon_triangulation_strategy);
+        if (const auto* cached = tessellation_cache.find(key, outline)) {
+            TessellationCache::resolve(*cached, outline, triangle_vertices);
+            return;
+        }
+        triangulate(outline, polygon_triangulation_strategy, scratch_tessellated_vertices);
+        tessellation_cache.insert(key, outline, scratch_tessellated_vertices);
+    } else {
+        triangulate(outline, polygon_triangulation_strategy, scratch_tessellated_vertices);
+    }
+    TessellationCache::resolve(scratch_tessellated_vertices, outline, triangle_vertices);
+}
+
+/**
+ * triangulates multiple independent polygon outlines. outlines that are not in the tessellation
+ * cache are triangulated in parallel on the shared worker pool if there are enough of them.
+ * @param outlines
+ * @param triangle_vertices one list of triangles per outline
+ */
+void PGraphics::tessellate_polygons(const std::vector<std::vector<Vertex>>& outlines, std::vector<std::vector<Vertex>>& triangle_vertices) {
+    static constexpr size_t MIN_POLYGONS_FOR_WORKER_POOL = 32;
+
+    triangle_vertices.resize(outlines.size());
+    std::vector<size_t>   uncached;
+    std::vector<uint64_t> keys(outlines.size());
+    for (size_t i = 0; i < outlines.size(); ++i) {
+        if (tessellation_cache_enabled) {
+            keys[i] = TessellationCache::hash(outlines[i], polygon_triangulation_strategy);
+            if (const auto* cached = tessellation_cache.find(keys[i], outlines[i])) {
+                TessellationCache::resolve(*cached, outlines[i], triangle_vertices[i]);
+                continue;
+            }
+        }
+        uncached.push_back(i);
+    }
+
+    // NOTE workers only write to their own slots, cache is updated on this thread
+    std::vector<TessellationCache::Triangles> triangles(uncached.size());
+    const int                                 strategy = polygon_triangulation_strategy;
+    const auto                                task     = [&](const size_t j) {
+        const std::vector<Vertex>& outline = outlines[uncached[j]];
+        triangulate(outline, strategy, triangles[j]);
+        TessellationCache::resolve(triangles[j], outline, triangle_vertices[uncached[j]]);
+    };
+    if (uncached.size() >= MIN_POLYGONS_FOR_WORKER_POOL) {
+        shared_worker_pool().parallel_for(uncached.size(), task);
+    } else {
+        for (size_t j = 0; j < uncached.size(); ++j) {
+            task(j);
+        }
+    }
+
+    if (tessellation_cache_enabled) {
+        for (size_t j = 0; j < uncached.size(); ++j) {
+            tessellation_cache.insert(keys[uncached[j]], outlines[uncached[j]], triangles[j]);
+        }
+    }
+}
+
+void PGraphics::polygons(const std::vector<std::vector<glm::vec3>>& outlines, const bool close_shape) {
+    if (!color_stroke.active && !color_fill.active) {
+        return;
+    }
+
+    if (color_fill.active) {
+        const glm::vec4 fill_color = as_vec4(color_fill);
+        scratch_polygon_outlines.resize(outlines.size());
+        for (size_t i = 0; i < outlines.size(); ++i) {
+            scratch_polygon_outlines[i].clear();
+            for (const auto& p: outlines[i]) {
+                scratch_polygon_outlines[i].emplace_back(p, fill_color, glm::vec2{0, 0}, current_normal);
+            }
+        }
+        tessellate_polygons(scratch_polygon_outlines, scratch_polygon_triangles);
+    }
+
+    // NOTE emit in order to keep fill and stroke of each polygon together
+    const glm::vec4 stroke_color = as_vec4(color_stroke);
+    for (size_t i = 0; i < outlines.size(); ++i) {
+        if (color_fill.active && !scratch_polygon_triangles[i].empty()) {
+            emit_shape_fill_triangles(scratch_polygon_triangles[i]);
+        }
+        if (color_stroke.active && !outlines[i].empty()) {
+            scratch_polygon_stroke.clear();
+            for (const auto& p: outlines[i]) {
+                scratch_polygon_stroke.emplace_back(p, stroke_color, glm::vec2{0, 0}, current_normal);
+            }
+            emit_shape_stroke_line_strip(scratch_polygon_stroke, close_shape);
+        }
+    }
+}
+
 void PGraphics::process_collected_stroke_vertices(const bool close_shape) {
     const int tmp_shape_mode_cache = shape_mode_cache;
     if (!shape_stroke_vertex_buffer.empty()) {
@@ -1192,8 +1755,8 @@ void PGraphics::process_collected_stroke_vertices(const bool close_shape) {
             //     OGL_tranform_model_matrix_and_render_vertex_buffer(IM_primitive_shape, GL_POINTS, shape_stroke_vertex_buffer);
             // }
             if (point_render_mode == POINT_RENDER_MODE_TRIANGULATE) {
-                std::vector<Vertex> line_vertices = convertPointsToTriangles(shape_stroke_vertex_buffer, point_size);
-                emit_shape_fill_triangles(line_vertices);
+                convertPointsToTriangles(shape_stroke_vertex_buffer, point_size, scratch_stroke_primitives);
+                emit_shape_fill_triangles(scratch_stroke_primitives);
             }
             return; // NOTE rendered as points exit early
         }
@@ -1202,39 +1765,39 @@ void PGraphics::process_collected_stroke_vertices(const bool close_shape) {
             case LINES: {
                 const int buffer_size = shape_stroke_vertex_buffer.size() / 2 * 2;
                 for (int i = 0; i < buffer_size; i += 2) {
-                    std::vector line = {shape_stroke_vertex_buffer[i], shape_stroke_vertex_buffer[i + 1]};
-                    emit_shape_stroke_line_strip(line, false);
+                    scratch_stroke_line.assign(shape_stroke_vertex_buffer.begin() + i, shape_stroke_vertex_buffer.begin() + i + 2);
+                    emit_shape_stroke_line_strip(scratch_stroke_line, false);
                 }
             } break;
             case TRIANGLE_FAN: {
-                const std::vector<Vertex> _triangle_vertices = convertTriangleFanToTriangles(shape_stroke_vertex_buffer);
-                const int                 buffer_size        = _triangle_vertices.size() / 3 * 3;
+                convertTriangleFanToTriangles(shape_stroke_vertex_buffer, scratch_stroke_primitives);
+                const int buffer_size = scratch_stroke_primitives.size() / 3 * 3;
                 for (int i = 0; i < buffer_size; i += 3) {
-                    std::vector line = {_triangle_vertices[i], _triangle_vertices[i + 1], _triangle_vertices[i + 2]};
-                    emit_shape_stroke_line_strip(line, true);
+                    scratch_stroke_line.assign(scratch_stroke_primitives.begin() + i, scratch_stroke_primitives.begin() + i + 3);
+                    emit_shape_stroke_line_strip(scratch_stroke_line, true);
                 }
             } break;
             case TRIANGLES: {
                 const int buffer_size = shape_stroke_vertex_buffer.size() / 3 * 3;
                 for (int i = 0; i < buffer_size; i += 3) {
-                    std::vector line = {shape_stroke_vertex_buffer[i], shape_stroke_vertex_buffer[i + 1], shape_stroke_vertex_buffer[i + 2]};
-                    emit_shape_stroke_line_strip(line, true);
+                    scratch_stroke_line.assign(shape_stroke_vertex_buffer.begin() + i, shape_stroke_vertex_buffer.begin() + i + 3);
+                    emit_shape_stroke_line_strip(scratch_stroke_line, true);
                 }
             } break;
             case TRIANGLE_STRIP: {
-                const std::vector<Vertex> _triangle_vertices = convertTriangleStripToTriangles(shape_stroke_vertex_buffer);
-                const int                 buffer_size        = _triangle_vertices.size() / 3 * 3;
+                convertTriangleStripToTriangles(shape_stroke_vertex_buffer, scratch_stroke_primitives);
+                const int buffer_size = scratch_stroke_primitives.size() / 3 * 3;
                 for (int i = 0; i < buffer_size; i += 3) {
-                    std::vector line = {_triangle_vertices[i], _triangle_vertices[i + 1], _triangle_vertices[i + 2]};
-                    emit_shape_stroke_line_strip(line, true);
+                    scratch_stroke_line.assign(scratch_stroke_primitives.begin() + i, scratch_stroke_primitives.begin() + i + 3);
+                    emit_shape_stroke_line_strip(scratch_stroke_line, true);
                 }
             } break;
             case QUAD_STRIP: {
-                const std::vector<Vertex> _quad_vertices = convertQuadStripToQuads(shape_stroke_vertex_buffer);
-                const int                 buffer_size    = _quad_vertices.size() / 4 * 4;
+                convertQuadStripToQuads(shape_stroke_vertex_buffer, scratch_stroke_primitives);
+                const int buffer_size = scratch_stroke_primitives.size() / 4 * 4;
                 for (int i = 0; i < buffer_size; i += 4) {
-                    std::vector line = {_quad_vertices[i], _quad_vertices[i + 1], _quad_vertices[i + 2], _quad_vertices[i + 3]};
-                    emit_shape_stroke_line_strip(line, true);
+                    scratch_stroke_line.assign(scratch_stroke_primitives.begin() + i, scratch_stroke_primitives.begin() + i + 4);
+                    emit_shape_stroke_line_strip(scratch_stroke_line, true);
                 }
             } break;
             case LINE_STRIP: {
@@ -1243,8 +1806,8 @@ void PGraphics::process_collected_stroke_vertices(const bool close_shape) {
             case QUADS: {
                 const int buffer_size = shape_stroke_vertex_buffer.size() / 4 * 4;
                 for (int i = 0; i < buffer_size; i += 4) {
-                    std::vector line = {shape_stroke_vertex_buffer[i], shape_stroke_vertex_buffer[i + 1], shape_stroke_vertex_buffer[i + 2], shape_stroke_vertex_buffer[i + 3]};
-                    emit_shape_stroke_line_strip(line, true);
+                    scratch_stroke_line.assign(shape_stroke_vertex_buffer.begin() + i, shape_stroke_vertex_buffer.begin() + i + 4);
+                    emit_shape_stroke_line_strip(scratch_stroke_line, true);
                 }
             }
             default:
@@ -645,12 +645,49 @@ void PGraphicsOpenGLv20::hint(const uint16_t property) {
             glDisable(GL_DEPTH_TEST);
             break;
         default:
+            PGraphics::hint(property);
             break;
     }
 }
 
-void PGraphicsOpenGLv20::upload_texture(PImage* img, const uint32_t* pixel_data, int width, int height, int offset_x, int offset_y, bool mipmapped) {
-    error("`upload_texture` not implemented ( might be called from `PImage`, `Capture` ,or `Movie` )");
+void PGraphicsOpenGLv20::upload_texture(PImage*         img,
+                                        const uint32_t* pixel_data,
+                                        const int       width,
+                                        const int       height,
+                                        const int       offset_x,
+                                        const int       offset_y,
+                                        const bool      mipmapped,
+                                        const int       pixel_data_row_length) {
+    // NOTE only updates existing textures ( e.g font atlas pages ). textures are created in `IMPL_set_texture`
+    if (img == nullptr || pixel_data == nullptr) {
+        return;
+    }
+    if (img->texture_id < TEXTURE_VALID_ID) {
+        error("`upload_texture` texture has not been initialized yet");
+        return;
+    }
+    if (width <= 0 || height <= 0 ||
+        offset_x < 0 || offset_y < 0 ||
+        offset_x + width > img->width || offset_y + height > img->height) {
+        error("`upload_texture` parameters exceed image dimensions");
+        return;
+    }
+
+    const int tmp_bound_texture = texture_id_current;
+    IMPL_bind_texture(img->texture_id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixel_data_row_length > width ? pixel_data_row_length : 0);
+    glTexSubImage2D(GL_TEXTURE_2D,
+                    0, offset_x, offset_y,
+                    width, height,
+                    UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
+                    UMFELD_DEFAULT_TEXTURE_PIXEL_TYPE,
+                    pixel_data);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (mipmapped) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    IMPL_bind_texture(tmp_bound_texture);
 }
 
 void PGraphicsOpenGLv20::download_texture(PImage* img) {
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <vector>
+#include <cstring>
 
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
@@ -32,17 +33,26 @@
 #include "VertexBuffer.h"
 #include "PShader.h"
 #include "ShaderSourceColorTexture.h"
+#include "ShaderSourceColorTextureInstanced.h"
+#include "ShaderSourceOIT.h"
+#include "ShaderSourceStroke.h"
+#include "ShaderSourceSDF.h"
 
 using namespace umfeld;
 
 PGraphicsOpenGLv33::PGraphicsOpenGLv33(const bool render_to_offscreen) : PImage(0, 0, 0) {
     this->render_to_offscreen = render_to_offscreen;
+    text_batching             = true;
 }
 
 void PGraphicsOpenGLv33::IMPL_background(const float a, const float b, const float c, const float d) {
+    // NOTE everything collected so far would be cleared anyways
+    RM_discard();
+    OIT_discard();
+    translucent_discard();
+    text_discard();
     glClearColor(a, b, c, d);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    // TODO should this also flush bins?
 }
 
 void PGraphicsOpenGLv33::IMPL_bind_texture(const int bind_texture_id) {
@@ -108,41 +118,64 @@ void PGraphicsOpenGLv33::emit_shape_stroke_line_strip(std::vector<Vertex>& line_
 
     // TODO maybe add stroke recorder here ( need to transform vertices to world space )
 
+    text_flush(); // NOTE keeps drawing order with batched text
+
+    // NOTE geometry shader strokes fall back to CPU triangulation if a custom shader is active
+    int stroke_render_mode = line_render_mode;
+    if (stroke_render_mode == STROKE_RENDER_MODE_GEOMETRY_SHADER && (stroke_shader == nullptr || current_shader != default_shader)) {
+        stroke_render_mode = STROKE_RENDER_MODE_TRIANGULATE_2D;
+    }
+
     if (render_mode == RENDER_MODE_BUFFERED) {
-        if (line_render_mode == STROKE_RENDER_MODE_TRIANGULATE_2D) {
-            std::vector<Vertex> line_vertices;
-            triangulate_line_strip_vertex(line_strip_vertices, line_strip_closed, line_vertices);
-            // TODO collect `line_vertices` and render as `GL_TRIANGLES` at end of frame
+        if (stroke_render_mode == STROKE_RENDER_MODE_TRIANGULATE_2D) {
+            scratch_stroke_vertices.clear();
+            triangulate_line_strip_vertex(line_strip_vertices, line_strip_closed, scratch_stroke_vertices);
+            RM_add_vertices(GL_TRIANGLES, scratch_stroke_vertices, false); // NOTE vertices are already in screen space
+        }
+        if (stroke_render_mode == STROKE_RENDER_MODE_GEOMETRY_SHADER) {
+            OGL3_line_strip_to_adjacency(line_strip_vertices, line_strip_closed, scratch_stroke_vertices);
+            RM_add_vertices(GL_LINES_ADJACENCY, scratch_stroke_vertices, true); // NOTE expanded with `stroke_shader` in `RM_flush()`
+        }
+        if (stroke_render_mode == STROKE_RENDER_MODE_NATIVE) {
+            RM_add_line_strip(line_strip_vertices, line_strip_closed);
         }
-        if (line_render_mode == STROKE_RENDER_MODE_NATIVE) {
-            // TODO collect `line_strip_vertices` and render as `GL_LINE_STRIP` at end of frame
+        if (stroke_render_mode == STROKE_RENDER_MODE_TUBE_3D) {
+            const std::vector<Vertex> line_vertices = generateTubeMesh(line_strip_vertices,
+                                                                       stroke_weight / 2.0f,
+                                                                       line_strip_closed,
+                                                                       color_stroke);
+            RM_add_vertices(GL_TRIANGLES, line_vertices, true);
         }
     }
 
     if (render_mode == RENDER_MODE_IMMEDIATE) {
         // TODO add other render modes:
-        //      - STROKE_RENDER_MODE_TUBE_3D
         //      - STROKE_RENDER_MODE_BARYCENTRIC_SHADER
-        //      - STROKE_RENDER_MODE_GEOMETRY_SHADER
-        if (vertex_buffer_data.uninitialized()) {
-            OGL3_init_vertex_buffer(vertex_buffer_data);
+        VertexBufferData& vertex_buffer = current_vertex_buffer();
+        if (vertex_buffer.uninitialized()) {
+            OGL3_init_vertex_buffer(vertex_buffer);
         }
-        if (line_render_mode == STROKE_RENDER_MODE_TRIANGULATE_2D) {
-            std::vector<Vertex> line_vertices;
-            triangulate_line_strip_vertex(line_strip_vertices, line_strip_closed, line_vertices);
-            OGL3_render_vertex_buffer(vertex_buffer_data, GL_TRIANGLES, line_vertices);
+        if (stroke_render_mode == STROKE_RENDER_MODE_TRIANGULATE_2D) {
+            scratch_stroke_vertices.clear();
+            triangulate_line_strip_vertex(line_strip_vertices, line_strip_closed, scratch_stroke_vertices);
+            OGL3_set_default_shader_model_matrix(glm::mat4(1.0f)); // NOTE vertices are already projected on CPU
+            OGL3_render_vertex_buffer(vertex_buffer, GL_TRIANGLES, scratch_stroke_vertices);
         }
-        if (line_render_mode == STROKE_RENDER_MODE_NATIVE) {
-            OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer_data, GL_LINE_STRIP, line_strip_vertices);
+        if (stroke_render_mode == STROKE_RENDER_MODE_NATIVE) {
+            OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer, GL_LINE_STRIP, line_strip_vertices);
         }
-        if (line_render_mode == STROKE_RENDER_MODE_TUBE_3D) {
+        if (stroke_render_mode == STROKE_RENDER_MODE_TUBE_3D) {
             const std::vector<Vertex> line_vertices = generateTubeMesh(line_strip_vertices,
                                                                        stroke_weight / 2.0f,
                                                                        line_strip_closed,
                                                                        color_stroke);
-            OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer_data, GL_TRIANGLES, line_vertices);
+            OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer, GL_TRIANGLES, line_vertices);
         }
-        if (line_render_mode == STROKE_RENDER_MODE_GEOMETRY_SHADER) {
+        if (stroke_render_mode == STROKE_RENDER_MODE_GEOMETRY_SHADER) {
+            OGL3_line_strip_to_adjacency(line_strip_vertices, line_strip_closed, scratch_stroke_vertices);
+            OGL3_use_stroke_shader(model_matrix);
+            OGL3_render_vertex_buffer(vertex_buffer, GL_LINES_ADJACENCY, scratch_stroke_vertices);
+            current_shader->use();
         }
     }
 
@@ -173,31 +206,57 @@ void PGraphicsOpenGLv33::emit_shape_fill_triangles(std::vector<Vertex>& triangle
 
     // TODO maybe add triangle recorder here ( need to transform vertices to world space )
 
+    text_flush(); // NOTE keeps drawing order with batched text
+
+    if (oit_enabled && current_shader == default_shader && has_translucent_vertices(triangle_vertices)) {
+        OIT_add_vertices(triangle_vertices); // NOTE composited in `OIT_resolve()`
+        return;
+    }
+
+    if (depth_sort_translucent && current_shader == default_shader && has_translucent_vertices(triangle_vertices)) {
+        translucent_enqueue(triangle_vertices); // NOTE sorted and emitted in `RM_flush()`
+        return;
+    }
+
     if (render_mode == RENDER_MODE_BUFFERED) {
-        // TODO collect triangles and current texture information for retained mode here.
-        //      - maybe sort by transparency ( and by depth )
-        //      - maybe sort transparent triangles by depth
-        //      - maybe sort by fill and stroke
-        //      ```C
-        //      add_stroke_vertex_xyz_rgba(position, color, tex_coord); // applies transformation
-        //      ... // add more triangle_vertices … maybe optimize by adding multiple triangle_vertices at once
-        //      RM_add_texture_id_to_render_batch(triangle_vertices,num_vertices,batch_texture_id);
-        //      ```
+        // TODO - maybe sort by fill and stroke
+        RM_add_vertices(GL_TRIANGLES, triangle_vertices, true);
     }
     if (render_mode == RENDER_MODE_IMMEDIATE) {
-        if (vertex_buffer_data.uninitialized()) {
-            OGL3_init_vertex_buffer(vertex_buffer_data);
+        VertexBufferData& vertex_buffer = current_vertex_buffer();
+        if (vertex_buffer.uninitialized()) {
+            OGL3_init_vertex_buffer(vertex_buffer);
         }
-        OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer_data, GL_TRIANGLES, triangle_vertices);
+        OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer, GL_TRIANGLES, triangle_vertices);
     }
 }
 
+/**
+ * draws text triangles ( in world space ) from a signed distance field atlas with `sdf_shader`. text
+ * is drawn immediately, collected vertices are flushed first to keep the drawing order.
+ */
+void PGraphicsOpenGLv33::emit_text_signed_distance_field(std::vector<Vertex>& triangle_vertices) {
+    // NOTE custom shaders get the distance field as alpha
+    if (sdf_shader == nullptr || current_shader != default_shader) {
+        emit_shape_fill_triangles(triangle_vertices);
+        return;
+    }
+
+    RM_flush();
+    sdf_shader->use();
+    OGL3_set_view_projection_matrix(sdf_shader);
+    sdf_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, glm::mat4(1.0f));
+    OGL3_render_vertex_buffer(current_vertex_buffer(), GL_TRIANGLES, triangle_vertices);
+    current_shader->use();
+}
+
 // TODO could move this to a shared method in `PGraphics` and use beginShape(TRIANGLES)
 void PGraphicsOpenGLv33::debug_text(const std::string& text, const float x, const float y) {
+    RM_flush();
     const std::vector<Vertex> triangle_vertices = debug_font.generate(text, x, y, glm::vec4(color_fill));
     push_texture_id();
     IMPL_bind_texture(debug_font.textureID);
-    OGL3_tranform_model_matrix_and_render_vertex_buffer(vertex_buffer_data, GL_TRIANGLES, triangle_vertices);
+    OGL3_tranform_model_matrix_and_render_vertex_buffer(current_vertex_buffer(), GL_TRIANGLES, triangle_vertices);
     pop_texture_id();
 }
 
@@ -220,86 +279,24 @@ void PGraphicsOpenGLv33::beginDraw() {
     PGraphicsOpenGL::beginDraw();
     texture_id_current = TEXTURE_NONE;
     IMPL_bind_texture(texture_id_solid_color);
-    default_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, model_matrix);
-    default_shader->set_uniform(SHADER_UNIFORM_VIEW_MATRIX, view_matrix);
-    default_shader->set_uniform(SHADER_UNIFORM_PROJECTION_MATRIX, projection_matrix);
+    // NOTE the binding point is shared by all graphics in the same context
+    glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_UNIFORM_BLOCK_MATRICES_BINDING, matrices_UBO);
+    OGL3_update_matrices_UBO();
+    OGL3_set_default_shader_model_matrix(model_matrix);
+    OGL3_set_view_projection_matrix(default_shader);
 }
 
 void PGraphicsOpenGLv33::endDraw() {
-    if (render_mode == RENDER_MODE_BUFFERED) {
-        // TODO flush collected vertices
-        // RM_flush_fill();
-        // RM_flush_stroke();
-        // void PGraphicsOpenGLv33::RM_flush_stroke() {
-        //     if (stroke_vertices_xyz_rgba.empty()) {
-        //         return;
-        //     }
-        //
-        //     // glEnable(GL_BLEND);
-        //     // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        //
-        //     glBindBuffer(GL_ARRAY_BUFFER, stroke_VBO_xyz_rgba);
-        //     const unsigned long size = stroke_vertices_xyz_rgba.size() * sizeof(float);
-        //     glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), stroke_vertices_xyz_rgba.data());
-        //
-        //     glUseProgram(stroke_shader_program);
-        //
-        //     // Upload matrices
-        //     const GLint projLoc = glGetUniformLocation(stroke_shader_program, "uProjection");
-        //     glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection_matrix)); // or projection2D
-        //
-        //     const GLint viewLoc = glGetUniformLocation(stroke_shader_program, "uViewMatrix");
-        //     glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view_matrix));
-        //
-        //     const GLint matrixLoc = glGetUniformLocation(stroke_shader_program, SHADER_UNIFORM_MODEL_MATRIX);
-        //     glUniformMatrix4fv(matrixLoc, 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
-        //
-        //     glBindVertexArray(stroke_VAO_xyz_rgba);
-        //     glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(stroke_vertices_xyz_rgba.size()) / NUM_STROKE_VERTEX_ATTRIBUTES_XYZ_RGBA);
-        //     glBindVertexArray(0);
-        //
-        //     stroke_vertices_xyz_rgba.clear();
-        // }
-        //
-        // void PGraphicsOpenGLv33::RM_flush_fill() {
-        //     if (fill_vertices_xyz_rgba_uv.empty()) {
-        //         return;
-        //     }
-        //
-        //     // glEnable(GL_BLEND);
-        //     // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        //
-        //     glBindBuffer(GL_ARRAY_BUFFER, fill_VBO_xyz_rgba_uv);
-        //     const unsigned long size = fill_vertices_xyz_rgba_uv.size() * sizeof(float);
-        //     glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), fill_vertices_xyz_rgba_uv.data());
-        //
-        //     glUseProgram(fill_shader_program);
-        //
-        //     // Upload matrices
-        //     const GLint projLoc = glGetUniformLocation(fill_shader_program, "uProjection");
-        //     glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection_matrix));
-        //
-        //     const GLint viewLoc = glGetUniformLocation(fill_shader_program, "uViewMatrix");
-        //     glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view_matrix));
-        //
-        //     const GLint modelLoc = glGetUniformLocation(fill_shader_program, SHADER_UNIFORM_MODEL_MATRIX);
-        //     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
-        //
-        //     // Bind textures per batch
-        //     glBindVertexArray(fill_VAO_xyz_rgba_uv);
-        //     for (const auto& batch: renderBatches) {
-        //         glBindTexture(GL_TEXTURE_2D, batch.texture_id); // NOTE no need to use `IMPL_bind_texture()`
-        //         glDrawArrays(GL_TRIANGLES, batch.start_index, batch.num_vertices);
-        //     }
-        //     glBindTexture(GL_TEXTURE_2D, 0); // NOTE no need to use `IMPL_bind_texture()`
-        //     glBindVertexArray(0);
-        //
-        //     fill_vertices_xyz_rgba_uv.clear();
-        //     renderBatches.clear();
-        // }
-    }
-
+    RM_flush(); // NOTE flush collected vertices ( if any )
+    OIT_resolve();
     PGraphicsOpenGL::endDraw();
+    while (OGL3_complete_framebuffer_readback(false)) {} // NOTE hand over finished readbacks without waiting
+}
+
+void PGraphicsOpenGLv33::blendMode(const int mode) {
+    RM_flush(); // NOTE blend state is not part of a render batch
+    blend_mode_current = mode;
+    PGraphicsOpenGL::blendMode(mode);
 }
 
 void PGraphicsOpenGLv33::render_framebuffer_to_screen(const bool use_blit) {
@@ -332,6 +329,7 @@ void PGraphicsOpenGLv33::render_framebuffer_to_screen(const bool use_blit) {
 }
 
 void PGraphicsOpenGLv33::hint(const uint16_t property) {
+    RM_flush();
     // TODO @MERGE
     switch (property) {
         case ENABLE_SMOOTH_LINES:
@@ -349,7 +347,27 @@ void PGraphicsOpenGLv33::hint(const uint16_t property) {
         case DISABLE_DEPTH_TEST:
             glDisable(GL_DEPTH_TEST);
             break;
+        case ENABLE_PACKED_VERTICES:
+            use_packed_vertices = true;
+            break;
+        case DISABLE_PACKED_VERTICES:
+            use_packed_vertices = false;
+            break;
+        case ENABLE_ORDER_INDEPENDENT_TRANSPARENCY:
+            oit_enabled = true;
+            break;
+        case DISABLE_ORDER_INDEPENDENT_TRANSPARENCY:
+            OIT_resolve();
+            oit_enabled = false;
+            break;
+        case ENABLE_DEPTH_SORT_TRANSLUCENT:
+            depth_sort_translucent = true;
+            break;
+        case DISABLE_DEPTH_SORT_TRANSLUCENT:
+            depth_sort_translucent = false;
+            break;
         default:
+            PGraphics::hint(property);
             break;
     }
 }
@@ -360,7 +378,8 @@ void PGraphicsOpenGLv33::upload_texture(PImage*         img,
                                         const int       height,
                                         const int       offset_x,
                                         const int       offset_y,
-                                        const bool      mipmapped) {
+                                        const bool      mipmapped,
+                                        const int       pixel_data_row_length) {
     if (img == nullptr) {
         return;
     }
@@ -394,20 +413,85 @@ void PGraphicsOpenGLv33::upload_texture(PImage*         img,
         return;
     }
 
+    const int row_length = pixel_data_row_length > width ? pixel_data_row_length : width;
+
     const int tmp_bound_texture = texture_id_current;
     IMPL_bind_texture(img->texture_id);
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-    glTexSubImage2D(GL_TEXTURE_2D,
-                    0, offset_x, offset_y,
-                    width, height,
-                    UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
-                    UMFELD_DEFAULT_TEXTURE_PIXEL_TYPE,
-                    pixel_data);
+    const int num_bytes = width * height * static_cast<int>(sizeof(uint32_t));
+    if (num_bytes >= PBO_UPLOAD_MIN_BYTES && OGL3_stage_pixel_unpack_buffer(pixel_data, row_length, width, height)) {
+        // NOTE pixels are read from the bound pixel unpack buffer, the call returns without waiting for the transfer
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0, offset_x, offset_y,
+                        width, height,
+                        UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
+                        UMFELD_DEFAULT_TEXTURE_PIXEL_TYPE,
+                        nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length == width ? 0 : row_length);
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0, offset_x, offset_y,
+                        width, height,
+                        UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
+                        UMFELD_DEFAULT_TEXTURE_PIXEL_TYPE,
+                        pixel_data);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    if (mipmapped) {
+        glGenerateMipmap(GL_TEXTURE_2D); // NOTE otherwise minified textures show outdated content
+    }
 
     IMPL_bind_texture(tmp_bound_texture);
 }
 
+/**
+ * copies pixels ( rows `pixel_data_row_length` pixels apart ) tightly packed into the next pixel
+ * unpack buffer of the ring and leaves it bound to `GL_PIXEL_UNPACK_BUFFER`. the buffer is
+ * invalidated before mapping so the driver does not need to wait for a previous transfer.
+ * @return false if the buffer could not be mapped ( nothing is bound then )
+ */
+bool PGraphicsOpenGLv33::OGL3_stage_pixel_unpack_buffer(const uint32_t* pixel_data,
+                                                        const int       pixel_data_row_length,
+                                                        const int       width,
+                                                        const int       height) {
+    PixelUnpackBuffers& buffers = pixel_unpack_buffers;
+    const int           i       = buffers.index;
+    buffers.index               = (buffers.index + 1) % PixelUnpackBuffers::NUM_BUFFERS;
+
+    if (buffers.PBO[i] == 0) {
+        glGenBuffers(1, &buffers.PBO[i]);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffers.PBO[i]);
+    const GLsizeiptr num_bytes = static_cast<GLsizeiptr>(width) * height * sizeof(uint32_t);
+    if (buffers.size[i] < num_bytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, num_bytes, nullptr, GL_STREAM_DRAW);
+        buffers.size[i] = num_bytes;
+    }
+
+    auto* mapped = static_cast<uint32_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, num_bytes,
+                                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (mapped == nullptr) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+    if (pixel_data_row_length == width) {
+        std::memcpy(mapped, pixel_data, num_bytes);
+    } else {
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(mapped + static_cast<size_t>(y) * width,
+                        pixel_data + static_cast<size_t>(y) * pixel_data_row_length,
+                        width * sizeof(uint32_t));
+        }
+    }
+    if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); // NOTE buffer content was lost e.g by a display mode change
+        return false;
+    }
+    return true;
+}
+
 void PGraphicsOpenGLv33::download_texture(PImage* img) {
     if (img == nullptr) {
         return;
@@ -443,6 +527,24 @@ void PGraphicsOpenGLv33::init(uint32_t*  pixels,
     if (default_shader == nullptr) {
         error("Failed to load default shader.");
     }
+    instanced_shader = loadShader(shader_source_color_texture_instanced.vertex, shader_source_color_texture_instanced.fragment);
+    if (instanced_shader == nullptr) {
+        error("Failed to load instanced shader.");
+    }
+    stroke_shader = loadShader(shader_source_stroke.vertex, shader_source_stroke.fragment, shader_source_stroke.geometry);
+    if (stroke_shader == nullptr) {
+        error("Failed to load stroke shader.");
+    }
+    sdf_shader = loadShader(shader_source_sdf.vertex, shader_source_sdf.fragment);
+    if (sdf_shader == nullptr) {
+        error("Failed to load signed distance field shader.");
+    }
+    default_shader_model_matrix = default_shader->get_uniform_handle(SHADER_UNIFORM_MODEL_MATRIX);
+
+    glGenBuffers(1, &matrices_UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, matrices_UBO);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
     this->width        = width;
     this->height       = height;
@@ -578,7 +680,8 @@ void PGraphicsOpenGLv33::OGL3_init_vertex_buffer(VertexBufferData& vertex_buffer
     glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.VBO);
 
     // Allocate GPU memory (without initializing data, as it will be updated before use)
-    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_buffer.num_vertices * sizeof(Vertex)), nullptr, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_buffer.capacity) * vertex_buffer.stride(), nullptr, GL_STREAM_DRAW);
+    vertex_buffer.write_offset = 0;
 
     // set up attribute pointers. NOTE make sure to align to locations in shader.
     constexpr int ATTRIBUTE_LOCATION_POSITION = 0;
@@ -589,6 +692,20 @@ void PGraphicsOpenGLv33::OGL3_init_vertex_buffer(VertexBufferData& vertex_buffer
     constexpr int ATTRIBUTE_SIZE_NORMAL       = 4;
     constexpr int ATTRIBUTE_SIZE_COLOR        = 4;
     constexpr int ATTRIBUTE_SIZE_TEXCOORD     = 2;
+    if (vertex_buffer.packed) {
+        // NOTE packed attributes are expanded to floats by the attribute fetch i.e the default shader works unchanged
+        constexpr int ATTRIBUTE_SIZE_PACKED_POSITION = 3; // NOTE `w` defaults to 1.0
+        glVertexAttribPointer(ATTRIBUTE_LOCATION_POSITION, ATTRIBUTE_SIZE_PACKED_POSITION, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), reinterpret_cast<void*>(offsetof(PackedVertex, position)));
+        glEnableVertexAttribArray(ATTRIBUTE_LOCATION_POSITION);
+        glVertexAttribPointer(ATTRIBUTE_LOCATION_NORMAL, ATTRIBUTE_SIZE_NORMAL, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), reinterpret_cast<void*>(offsetof(PackedVertex, normal)));
+        glEnableVertexAttribArray(ATTRIBUTE_LOCATION_NORMAL);
+        glVertexAttribPointer(ATTRIBUTE_LOCATION_COLOR, ATTRIBUTE_SIZE_COLOR, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex), reinterpret_cast<void*>(offsetof(PackedVertex, color)));
+        glEnableVertexAttribArray(ATTRIBUTE_LOCATION_COLOR);
+        glVertexAttribPointer(ATTRIBUTE_LOCATION_TEXCOORD, ATTRIBUTE_SIZE_TEXCOORD, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), reinterpret_cast<void*>(offsetof(PackedVertex, tex_coord)));
+        glEnableVertexAttribArray(ATTRIBUTE_LOCATION_TEXCOORD);
+        glBindVertexArray(0);
+        return;
+    }
     glVertexAttribPointer(ATTRIBUTE_LOCATION_POSITION, ATTRIBUTE_SIZE_POSITION, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
     glEnableVertexAttribArray(ATTRIBUTE_LOCATION_POSITION);
     glVertexAttribPointer(ATTRIBUTE_LOCATION_NORMAL, ATTRIBUTE_SIZE_NORMAL, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
@@ -601,22 +718,67 @@ void PGraphicsOpenGLv33::OGL3_init_vertex_buffer(VertexBufferData& vertex_buffer
     glBindVertexArray(0);
 }
 
-void PGraphicsOpenGLv33::OGL3_resize_vertex_buffer(const size_t buffer_size_bytes) {
-    GLint bufferSize = 0;
-    glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &bufferSize);
+/**
+ * appends vertices to the streaming vertex buffer ( which needs to be bound to `GL_ARRAY_BUFFER` ).
+ * the buffer is written *unsynchronized* behind the previous upload. once the buffer is full it is
+ * orphaned i.e the driver hands out fresh storage while the GPU keeps reading from the old one.
+ * if the buffer is `packed` vertices are converted to `PackedVertex` ( into a reused scratch buffer )
+ * before uploading.
+ *
+ * @param vertex_buffer
+ * @param shape_vertices
+ * @return index of the first uploaded vertex ( to be used in `glDrawArrays` )
+ */
+GLint PGraphicsOpenGLv33::OGL3_stream_vertex_buffer(VertexBufferData& vertex_buffer, const std::vector<Vertex>& shape_vertices) {
+    const auto     num_vertices = static_cast<uint32_t>(shape_vertices.size());
+    const uint32_t stride       = vertex_buffer.stride();
+    const void*    vertex_data  = shape_vertices.data();
+    if (vertex_buffer.packed) {
+        scratch_packed_vertices.clear();
+        scratch_packed_vertices.reserve(num_vertices);
+        for (const auto& v: shape_vertices) {
+            scratch_packed_vertices.emplace_back(v);
+        }
+        vertex_data = scratch_packed_vertices.data();
+    }
 
-    if (buffer_size_bytes > static_cast<size_t>(bufferSize)) {
+    if (num_vertices > vertex_buffer.capacity) {
         // allocate extra space to reduce reallocations
-        const size_t growSize = std::max(static_cast<int>(buffer_size_bytes), bufferSize + static_cast<int>(VBO_BUFFER_CHUNK_SIZE));
-        console("increasing vertex buffer array to ", growSize, " ( no worries, this should be all good )");
-        glBufferData(GL_ARRAY_BUFFER, static_cast<int>(growSize), nullptr, GL_DYNAMIC_DRAW);
+        const uint32_t new_capacity = std::max(num_vertices, vertex_buffer.capacity + VBO_BUFFER_CHUNK_SIZE);
+        console("increasing vertex buffer array to ", static_cast<size_t>(new_capacity) * stride, " bytes ( no worries, this should be all good )");
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(new_capacity) * stride, nullptr, GL_STREAM_DRAW);
+        vertex_buffer.capacity     = new_capacity;
+        vertex_buffer.write_offset = 0;
+        vertex_buffer.stats.buffer_reallocations++;
+    } else if (vertex_buffer.write_offset + num_vertices > vertex_buffer.capacity) {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_buffer.capacity) * stride, nullptr, GL_STREAM_DRAW);
+        vertex_buffer.write_offset = 0;
+        vertex_buffer.stats.buffer_orphans++;
+    } else if (vertex_buffer.write_offset > 0) {
+        vertex_buffer.stats.stalls_avoided++;
+    }
+
+    const GLint      first_vertex = static_cast<GLint>(vertex_buffer.write_offset);
+    const GLintptr   offset_bytes = static_cast<GLintptr>(vertex_buffer.write_offset) * static_cast<GLintptr>(stride);
+    const GLsizeiptr size_bytes   = static_cast<GLsizeiptr>(num_vertices) * stride;
+    void*            mapped       = glMapBufferRange(GL_ARRAY_BUFFER, offset_bytes, size_bytes,
+                                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped != nullptr) {
+        std::memcpy(mapped, vertex_data, size_bytes);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset_bytes, size_bytes, vertex_data);
     }
+
+    vertex_buffer.write_offset += num_vertices;
+    vertex_buffer.stats.bytes_streamed += static_cast<uint64_t>(size_bytes);
+    vertex_buffer.stats.uploads++;
+    return first_vertex;
 }
 
 void PGraphicsOpenGLv33::OGL3_render_vertex_buffer(VertexBufferData&          vertex_buffer,
                                                    const GLenum               primitive_mode,
                                                    const std::vector<Vertex>& shape_vertices) {
-    // TODO maybe replace this with VertexBuffer
     // Ensure there are vertices to render
     if (shape_vertices.empty()) {
         return;
@@ -627,21 +789,13 @@ void PGraphicsOpenGLv33::OGL3_render_vertex_buffer(VertexBufferData&          ve
         OGL3_init_vertex_buffer(vertex_buffer);
     }
 
-    // Update VBO with collected vertex data
+    // Append vertex data to streaming buffer
     glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.VBO);
-
-    constexpr bool hint_check_buffer_size = true;
-    if (hint_check_buffer_size) {
-        const size_t buffer_size = shape_vertices.size() * sizeof(Vertex);
-        OGL3_resize_vertex_buffer(buffer_size);
-    }
-
-    // Update only necessary data
-    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<int>(shape_vertices.size() * sizeof(Vertex)), shape_vertices.data());
+    const GLint first_vertex = OGL3_stream_vertex_buffer(vertex_buffer, shape_vertices);
 
     // Bind VAO and draw the shape
     glBindVertexArray(vertex_buffer.VAO);
-    glDrawArrays(primitive_mode, 0, static_cast<GLsizei>(shape_vertices.size()));
+    glDrawArrays(primitive_mode, first_vertex, static_cast<GLsizei>(shape_vertices.size()));
 
     // Unbind VAO for safety (optional)
     glBindVertexArray(0);
@@ -649,7 +803,7 @@ void PGraphicsOpenGLv33::OGL3_render_vertex_buffer(VertexBufferData&          ve
 
 void PGraphicsOpenGLv33::OGL3_tranform_model_matrix_and_render_vertex_buffer(VertexBufferData&          vertex_buffer,
                                                                              const GLenum               mode,
-                                                                             const std::vector<Vertex>& shape_vertices) const {
+                                                                             const std::vector<Vertex>& shape_vertices) {
     static bool _emit_warning_only_once = false;
     if (mode != GL_TRIANGLES && mode != GL_LINE_STRIP) {
         if (!_emit_warning_only_once) {
@@ -665,45 +819,158 @@ void PGraphicsOpenGLv33::OGL3_tranform_model_matrix_and_render_vertex_buffer(Ver
 
     // NOTE depending on the number of vertices transformation are handle on the GPU
     //      i.e all shapes *up to* quads are transformed on CPU
+    //      only the ( few ) CPU transformed vertices are copied to a reused scratch buffer
     static constexpr int MAX_NUM_VERTICES_CLIENT_SIDE_TRANSFORM = 4;
     bool                 mModelMatrixTransformOnGPU             = false;
-    std::vector<Vertex>  transformed_vertices                   = shape_vertices; // NOTE make copy
+    bool                 mModelMatrixTransformOnCPU             = false;
     if (model_matrix_dirty) {
         if (shape_vertices.size() <= MAX_NUM_VERTICES_CLIENT_SIDE_TRANSFORM) {
+            mModelMatrixTransformOnCPU = true;
+            scratch_transformed_vertices.assign(shape_vertices.begin(), shape_vertices.end());
             const glm::mat4 modelview = model_matrix;
-            for (auto& p: transformed_vertices) {
+            for (auto& p: scratch_transformed_vertices) {
                 p.position = glm::vec4(modelview * p.position);
             }
         } else {
             mModelMatrixTransformOnGPU = true;
         }
     }
-    if (mModelMatrixTransformOnGPU) {
-        if (current_shader == default_shader) {
-            default_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, model_matrix);
-        }
+    // NOTE the model matrix is not reset after drawing. every draw ( including direct calls to
+    //      `OGL3_render_vertex_buffer` ) sets the matrix it needs and redundant updates are skipped
+    //      by the shader
+    OGL3_set_default_shader_model_matrix(mModelMatrixTransformOnGPU ? model_matrix : glm::mat4(1.0f));
+    OGL3_render_vertex_buffer(vertex_buffer, mode, mModelMatrixTransformOnCPU ? scratch_transformed_vertices : shape_vertices);
+}
+
+void PGraphicsOpenGLv33::mesh(VertexBuffer* mesh_shape) {
+    if (mesh_shape == nullptr) {
+        return;
+    }
+    RM_flush();
+    OGL3_set_default_shader_model_matrix(model_matrix);
+    mesh_shape->draw();
+}
+
+/**
+ * draws the mesh once per recorded instance with a single `glDrawArraysInstanced` call. if the
+ * default shader is active it is temporarily replaced by the instanced shader, a custom shader
+ * needs to declare the per-instance attributes itself ( see `ShaderSourceColorTextureInstanced.h` ).
+ * @param mesh_shape
+ */
+void PGraphicsOpenGLv33::endInstances(VertexBuffer* mesh_shape) {
+    instances_begun = false;
+    if (mesh_shape == nullptr || instances.empty()) {
+        instances.clear();
+        return;
+    }
+    RM_flush();
+    OGL3_upload_instance_buffer();
+
+    const bool use_instanced_shader = current_shader == default_shader && instanced_shader != nullptr;
+    if (use_instanced_shader) {
+        instanced_shader->use();
+        OGL3_set_view_projection_matrix(instanced_shader);
+        instanced_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, glm::mat4(1.0f)); // NOTE instances carry the model matrix
     }
-    OGL3_render_vertex_buffer(vertex_buffer, mode, transformed_vertices);
-    if (mModelMatrixTransformOnGPU) {
-        if (current_shader == default_shader) {
-            default_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, glm::mat4(1.0f));
+    mesh_shape->draw_instanced(instance_VBO, static_cast<int>(instances.size()));
+    if (use_instanced_shader) {
+        default_shader->use();
+    }
+    instances.clear();
+}
+
+void PGraphicsOpenGLv33::endInstances(const int instance_shape) {
+    // NOTE every shape type is generated once and kept, only the ellipse is regenerated if `ellipseDetail` changes
+    VertexBuffer*& mesh_shape      = instance_shape_meshes[instance_shape];
+    const bool     ellipse_changed = instance_shape == ELLIPSE && instance_shape_ellipse_detail != ellipse_points_LUT.size();
+    if (mesh_shape == nullptr || ellipse_changed) {
+        if (mesh_shape == nullptr) {
+            mesh_shape = new VertexBuffer();
+            mesh_shape->set_shape(TRIANGLES);
+        }
+        generate_instance_shape(instance_shape, scratch_instance_vertices);
+        mesh_shape->clear();
+        mesh_shape->add_vertices(scratch_instance_vertices);
+        if (instance_shape == ELLIPSE) {
+            instance_shape_ellipse_detail = ellipse_points_LUT.size();
         }
     }
+    endInstances(mesh_shape);
 }
 
-void PGraphicsOpenGLv33::mesh(VertexBuffer* mesh_shape) {
-    if (mesh_shape == nullptr) {
+/**
+ * converts a line strip into segments with adjacency information ( `GL_LINES_ADJACENCY` ) for the
+ * stroke shader. stroke weight, join and cap mode are stored in the texture coordinates.
+ * @param line_strip
+ * @param line_strip_closed
+ * @param adjacency_vertices
+ */
+void PGraphicsOpenGLv33::OGL3_line_strip_to_adjacency(const std::vector<Vertex>& line_strip,
+                                                      const bool                 line_strip_closed,
+                                                      std::vector<Vertex>&       adjacency_vertices) const {
+    adjacency_vertices.clear();
+    const size_t num_points = line_strip.size();
+    if (num_points < 2) {
         return;
     }
-    if (current_shader == default_shader) {
-        default_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, model_matrix);
+
+    // NOTE must match constants in `ShaderSourceStroke.h`
+    int join = 0; // BEVEL, BEVEL_FAST
+    if (stroke_join_mode == MITER || stroke_join_mode == MITER_FAST) {
+        join = 1;
+    } else if (stroke_join_mode == ROUND) {
+        join = 2;
+    } else if (stroke_join_mode == NONE) {
+        join = 3;
     }
-    mesh_shape->draw();
-    if (current_shader == default_shader) {
-        default_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, glm::mat4(1.0f));
+    int cap = 0; // SQUARE
+    if (stroke_cap_mode == PROJECT) {
+        cap = 1;
+    } else if (stroke_cap_mode == ROUND) {
+        cap = 2;
+    } else if (stroke_cap_mode == POINTED) {
+        cap = 3;
+    }
+    const float  mode_code    = static_cast<float>(join * 4 + cap);
+    const bool   closed       = line_strip_closed && num_points > 2;
+    const size_t num_segments = closed ? num_points : num_points - 1;
+    const auto   add_vertex   = [&](const Vertex& v, const float code) {
+        adjacency_vertices.push_back(v);
+        adjacency_vertices.back().tex_coord = glm::vec2(stroke_weight, code);
+    };
+    adjacency_vertices.reserve(num_segments * 4);
+    for (size_t i = 0; i < num_segments; ++i) {
+        const size_t i_start  = i;
+        const size_t i_end    = (i + 1) % num_points;
+        const bool   has_prev = closed || i > 0;
+        const bool   has_next = closed || i + 2 < num_points;
+        add_vertex(line_strip[has_prev ? (i + num_points - 1) % num_points : i_start], has_prev ? mode_code : -1.0f);
+        add_vertex(line_strip[i_start], mode_code);
+        add_vertex(line_strip[i_end], mode_code);
+        add_vertex(line_strip[has_next ? (i + 2) % num_points : i_end], has_next ? mode_code : -1.0f);
     }
 }
 
+void PGraphicsOpenGLv33::OGL3_use_stroke_shader(const glm::mat4& transform) const {
+    stroke_shader->use();
+    OGL3_set_view_projection_matrix(stroke_shader);
+    stroke_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, transform);
+    stroke_shader->set_uniform("uViewport", glm::vec2(width, height)); // NOTE stroke weight is in pixels like `STROKE_RENDER_MODE_TRIANGULATE_2D`
+    stroke_shader->set_uniform("uMiterMaxAngle", glm::radians(stroke_join_miter_max_angle));
+    stroke_shader->set_uniform("uJoinRoundResolution", stroke_join_round_resolution);
+    stroke_shader->set_uniform("uCapRoundResolution", stroke_cap_round_resolution);
+}
+
+void PGraphicsOpenGLv33::OGL3_upload_instance_buffer() {
+    if (instance_VBO == 0) {
+        glGenBuffers(1, &instance_VBO);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, instance_VBO);
+    // NOTE orphan buffer every time so that previous instanced draws are not stalled
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(InstanceData)), instances.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 PShader* PGraphicsOpenGLv33::loadShader(const std::string& vertex_code, const std::string& fragment_code, const std::string& geometry_code) {
     const auto _shader = new PShader();
     _shader->load(vertex_code, fragment_code, geometry_code);
@@ -715,17 +982,122 @@ void PGraphicsOpenGLv33::shader(PShader* shader) {
         resetShader();
         return;
     }
+    RM_flush();
     shader->use();
     current_shader = shader;
 }
 
 void PGraphicsOpenGLv33::resetShader() {
+    RM_flush();
     default_shader->use();
     current_shader = default_shader;
 }
 
 bool PGraphicsOpenGLv33::read_framebuffer(std::vector<unsigned char>& pixels) {
     store_fbo_state();
+    OGL3_bind_framebuffer_for_reading();
+    const bool success = OGL_read_framebuffer(framebuffer, pixels);
+    restore_fbo_state();
+    return success;
+}
+
+/**
+ * reads the framebuffer into a pixel pack buffer without waiting for the transfer. `callback` is
+ * called from `endDraw()` of a later frame once the pixels arrived ( or from
+ * `finish_framebuffer_readbacks()` ). if `MAX_PENDING_FRAMEBUFFER_READBACKS` are in flight the
+ * oldest one is completed first.
+ */
+bool PGraphicsOpenGLv33::read_framebuffer_async(const FramebufferReadbackCallback& callback) {
+    if (!callback) {
+        return false;
+    }
+    RM_flush(); // NOTE include everything drawn so far
+    if (framebuffer_readbacks.size() >= MAX_PENDING_FRAMEBUFFER_READBACKS) {
+        OGL3_complete_framebuffer_readback(true);
+    }
+
+    FramebufferReadback readback;
+    if (framebuffer_readback_PBOs.empty()) {
+        glGenBuffers(1, &readback.PBO);
+    } else {
+        readback.PBO = framebuffer_readback_PBOs.back();
+        framebuffer_readback_PBOs.pop_back();
+    }
+    readback.width    = framebuffer.width;
+    readback.height   = framebuffer.height;
+    readback.callback = callback;
+
+    store_fbo_state();
+    OGL3_bind_framebuffer_for_reading();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PBO);
+    glBufferData(GL_PIXEL_PACK_BUFFER,
+                 static_cast<GLsizeiptr>(readback.width) * readback.height * DEFAULT_BYTES_PER_PIXELS,
+                 nullptr, GL_STREAM_READ);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, readback.width, readback.height,
+                 UMFELD_DEFAULT_INTERNAL_PIXEL_FORMAT,
+                 UMFELD_DEFAULT_TEXTURE_PIXEL_TYPE,
+                 nullptr); // NOTE returns immediately, pixels are written to the bound pixel pack buffer
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    restore_fbo_state();
+
+    framebuffer_readbacks.push_back(std::move(readback));
+    return true;
+}
+
+void PGraphicsOpenGLv33::finish_framebuffer_readbacks() {
+    while (!framebuffer_readbacks.empty()) {
+        OGL3_complete_framebuffer_readback(true);
+    }
+}
+
+/**
+ * maps the oldest pending readback and passes its pixels to the callback.
+ * @param wait if false returns immediately if the transfer is not done yet
+ * @return true if the readback was completed
+ */
+bool PGraphicsOpenGLv33::OGL3_complete_framebuffer_readback(const bool wait) {
+    if (framebuffer_readbacks.empty()) {
+        return false;
+    }
+    FramebufferReadback& readback = framebuffer_readbacks.front();
+    const GLenum         status   = glClientWaitSync(readback.fence,
+                                                     wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                                     wait ? FRAMEBUFFER_READBACK_TIMEOUT_NS : 0);
+    if (status == GL_TIMEOUT_EXPIRED && !wait) {
+        return false;
+    }
+    if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+        warning("framebuffer readback did not finish in time. mapping the buffer might stall.");
+    }
+    glDeleteSync(readback.fence);
+
+    const size_t               num_bytes = static_cast<size_t>(readback.width) * readback.height * DEFAULT_BYTES_PER_PIXELS;
+    std::vector<unsigned char> pixels;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PBO);
+    const auto* mapped = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(num_bytes), GL_MAP_READ_BIT));
+    if (mapped != nullptr) {
+        pixels.assign(mapped, mapped + num_bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    framebuffer_readback_PBOs.push_back(readback.PBO);
+    const FramebufferReadbackCallback callback = std::move(readback.callback);
+    const int                         width    = readback.width;
+    const int                         height   = readback.height;
+    framebuffer_readbacks.pop_front();
+
+    if (mapped == nullptr) {
+        warning("could not map framebuffer readback buffer.");
+        return true;
+    }
+    callback(pixels, width, height);
+    return true;
+}
+
+void PGraphicsOpenGLv33::OGL3_bind_framebuffer_for_reading() const {
     if (framebuffer.msaa) {
         // NOTE this is a bit tricky. when the offscreen FBO is a multisample FBO ( MSAA ) we need to resolve it first
         //      i.e blit it into the color buffer of the default framebuffer. otherwise we can just read from the
@@ -739,13 +1111,11 @@ bool PGraphicsOpenGLv33::read_framebuffer(std::vector<unsigned char>& pixels) {
     } else {
         glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.id); // non-MSAA FBO or default
     }
-    const bool success = OGL_read_framebuffer(framebuffer, pixels);
-    restore_fbo_state();
-    return success;
 }
 
 void PGraphicsOpenGLv33::store_fbo_state() {
     glGetIntegerv(GL_CURRENT_PROGRAM, &previous_shader);
+    glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, SHADER_UNIFORM_BLOCK_MATRICES_BINDING, &previous_matrices_UBO);
     glGetIntegerv(GL_VIEWPORT, previous_viewport);
     glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previously_bound_read_FBO);
     glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previously_bound_draw_FBO);
@@ -760,30 +1130,343 @@ void PGraphicsOpenGLv33::restore_fbo_state() {
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previously_bound_draw_FBO);
     glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
     glUseProgram(previous_shader);
+    glBindBufferBase(GL_UNIFORM_BUFFER, SHADER_UNIFORM_BLOCK_MATRICES_BINDING, previous_matrices_UBO);
 }
 
 void PGraphicsOpenGLv33::camera(const float eyeX, const float eyeY, const float eyeZ, const float centerX, const float centerY, const float centerZ, const float upX, const float upY, const float upZ) {
+    RM_flush();
+    OIT_resolve(); // NOTE collected translucent fills depend on view and projection
     PGraphics::camera(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ);
     update_shader_view_matrix();
 }
 
 void PGraphicsOpenGLv33::frustum(const float left, const float right, const float bottom, const float top, const float near, const float far) {
+    RM_flush();
+    OIT_resolve();
     PGraphics::frustum(left, right, bottom, top, near, far);
     update_shader_view_matrix();
 }
 
 void PGraphicsOpenGLv33::ortho(const float left, const float right, const float bottom, const float top, const float near, const float far) {
+    RM_flush();
+    OIT_resolve();
     PGraphics::ortho(left, right, bottom, top, near, far);
     update_shader_view_matrix();
 }
 
 void PGraphicsOpenGLv33::perspective(const float fovy, const float aspect, const float near, const float far) {
+    RM_flush();
+    OIT_resolve();
     PGraphics::perspective(fovy, aspect, near, far);
     update_shader_view_matrix();
 }
 
-void PGraphicsOpenGLv33::update_shader_view_matrix() const {
+void PGraphicsOpenGLv33::update_shader_view_matrix() {
+    OGL3_update_matrices_UBO();
+    if (current_shader == default_shader) {
+        OGL3_set_view_projection_matrix(default_shader);
+    }
+}
+
+/**
+ * uploads projection and view matrix to the uniform buffer backing the `uMatrices` block. the buffer
+ * is only updated if one of the matrices changed.
+ */
+void PGraphicsOpenGLv33::OGL3_update_matrices_UBO() {
+    if (matrices_UBO == 0) {
+        return;
+    }
+    if (matrices_UBO_projection == projection_matrix && matrices_UBO_view == view_matrix) {
+        return;
+    }
+    matrices_UBO_projection = projection_matrix;
+    matrices_UBO_view       = view_matrix;
+    glBindBuffer(GL_UNIFORM_BUFFER, matrices_UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), &projection_matrix[0][0]);
+    glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), &view_matrix[0][0]);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+/**
+ * sets projection and view matrix for shaders that do not declare the `uMatrices` block ( e.g custom
+ * shaders ). shader needs to be in use.
+ */
+void PGraphicsOpenGLv33::OGL3_set_view_projection_matrix(PShader* shader) const {
+    if (shader == nullptr || shader->uses_matrix_block()) {
+        return;
+    }
+    shader->set_uniform(SHADER_UNIFORM_PROJECTION_MATRIX, projection_matrix);
+    shader->set_uniform(SHADER_UNIFORM_VIEW_MATRIX, view_matrix);
+}
+
+void PGraphicsOpenGLv33::OGL3_set_default_shader_model_matrix(const glm::mat4& matrix) const {
     if (current_shader == default_shader) {
-        default_shader->set_uniform(SHADER_UNIFORM_VIEW_MATRIX, view_matrix);
+        default_shader->set_uniform(default_shader_model_matrix, matrix);
+    }
+}
+
+/* --- buffered mode --- */
+
+void PGraphicsOpenGLv33::RM_add_vertices(const GLenum primitive_mode, const std::vector<Vertex>& vertices, const bool transform_to_world_space) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    const int start_index = static_cast<int>(buffered_vertices.size());
+    buffered_vertices.insert(buffered_vertices.end(), vertices.begin(), vertices.end());
+    if (transform_to_world_space && model_matrix_dirty) {
+        for (auto it = buffered_vertices.begin() + start_index; it != buffered_vertices.end(); ++it) {
+            it->position = glm::vec4(model_matrix * it->position);
+        }
+    }
+
+    // NOTE consecutive shapes with the same texture and primitive mode are merged into one batch
+    const int num_vertices = static_cast<int>(vertices.size());
+    if (!renderBatches.empty() &&
+        renderBatches.back().texture_id == static_cast<GLuint>(texture_id_current) &&
+        renderBatches.back().primitive_mode == primitive_mode) {
+        renderBatches.back().num_vertices += num_vertices;
+    } else {
+        renderBatches.emplace_back(start_index, num_vertices, texture_id_current, primitive_mode);
+    }
+}
+
+void PGraphicsOpenGLv33::RM_add_line_strip(const std::vector<Vertex>& line_strip_vertices, const bool line_strip_closed) {
+    if (line_strip_vertices.size() < 2) {
+        return;
+    }
+    // NOTE line strips are converted to line segments so that they can be merged into a single batch
+    scratch_stroke_vertices.clear();
+    for (size_t i = 0; i + 1 < line_strip_vertices.size(); ++i) {
+        scratch_stroke_vertices.push_back(line_strip_vertices[i]);
+        scratch_stroke_vertices.push_back(line_strip_vertices[i + 1]);
+    }
+    if (line_strip_closed && line_strip_vertices.size() > 2) {
+        scratch_stroke_vertices.push_back(line_strip_vertices.back());
+        scratch_stroke_vertices.push_back(line_strip_vertices.front());
+    }
+    RM_add_vertices(GL_LINES, scratch_stroke_vertices, true);
+}
+
+/**
+ * uploads all vertices collected since the last flush with a single buffer update and draws them
+ * with one draw call per batch. needs to be called before any state change that is not recorded in
+ * a `RenderBatch` ( e.g shader, blend mode, view and projection matrices ).
+ */
+void PGraphicsOpenGLv33::RM_flush() {
+    text_flush();
+    translucent_flush(); // NOTE appends sorted translucent triangles after everything opaque
+
+    if (renderBatches.empty()) {
+        buffered_vertices.clear();
+        return;
+    }
+
+    VertexBufferData& vertex_buffer = current_vertex_buffer();
+    if (vertex_buffer.uninitialized()) {
+        OGL3_init_vertex_buffer(vertex_buffer);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.VBO);
+    const GLint first_vertex = OGL3_stream_vertex_buffer(vertex_buffer, buffered_vertices);
+
+    const int tmp_bound_texture   = texture_id_current;
+    bool      stroke_shader_bound = false;
+    OGL3_set_default_shader_model_matrix(glm::mat4(1.0f)); // NOTE vertices are in world space
+    glBindVertexArray(vertex_buffer.VAO);
+    for (const auto& batch: renderBatches) {
+        // NOTE stroke segments are expanded in the stroke shader, all other batches use the current shader
+        const bool is_stroke_batch = batch.primitive_mode == GL_LINES_ADJACENCY;
+        if (is_stroke_batch != stroke_shader_bound) {
+            if (is_stroke_batch) {
+                OGL3_use_stroke_shader(glm::mat4(1.0f)); // NOTE vertices are in world space
+            } else {
+                current_shader->use();
+            }
+            stroke_shader_bound = is_stroke_batch;
+        }
+        IMPL_bind_texture(static_cast<int>(batch.texture_id));
+        glDrawArrays(batch.primitive_mode, first_vertex + batch.start_index, batch.num_vertices);
+    }
+    glBindVertexArray(0);
+    if (stroke_shader_bound) {
+        current_shader->use();
+    }
+    IMPL_bind_texture(tmp_bound_texture);
+
+    RM_discard();
+}
+
+void PGraphicsOpenGLv33::RM_discard() {
+    buffered_vertices.clear();
+    renderBatches.clear();
+}
+
+/* --- order-independent transparency --- */
+
+void PGraphicsOpenGLv33::OIT_add_vertices(const std::vector<Vertex>& vertices) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    const int start_index = static_cast<int>(oit_vertices.size());
+    oit_vertices.insert(oit_vertices.end(), vertices.begin(), vertices.end());
+    if (model_matrix_dirty) {
+        for (auto it = oit_vertices.begin() + start_index; it != oit_vertices.end(); ++it) {
+            it->position = glm::vec4(model_matrix * it->position);
+        }
+    }
+
+    const int num_vertices = static_cast<int>(vertices.size());
+    if (!oit_batches.empty() && oit_batches.back().texture_id == static_cast<GLuint>(texture_id_current)) {
+        oit_batches.back().num_vertices += num_vertices;
+    } else {
+        oit_batches.emplace_back(start_index, num_vertices, texture_id_current, GL_TRIANGLES);
     }
 }
+
+void PGraphicsOpenGLv33::OIT_init_buffers(const int width, const int height) {
+    if (!oit.uninitialized() && oit.width == width && oit.height == height) {
+        return;
+    }
+
+    if (oit.accumulate_shader == nullptr) {
+        oit.accumulate_shader = loadShader(shader_source_oit_accumulate.vertex, shader_source_oit_accumulate.fragment);
+        oit.composite_shader  = loadShader(shader_source_oit_composite.vertex, shader_source_oit_composite.fragment);
+        glGenVertexArrays(1, &oit.VAO);
+    }
+
+    if (oit.uninitialized()) {
+        glGenFramebuffers(1, &oit.FBO);
+        glGenTextures(1, &oit.accumulation_texture);
+        glGenTextures(1, &oit.weight_texture);
+        glGenRenderbuffers(1, &oit.depth_renderbuffer);
+    }
+    oit.width  = width;
+    oit.height = height;
+
+    const GLuint textures[2] = {oit.accumulation_texture, oit.weight_texture};
+    for (const GLuint texture: textures) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, texture_id_current); // NOTE restore texture binding cached in `IMPL_bind_texture()`
+
+    glBindRenderbuffer(GL_RENDERBUFFER, oit.depth_renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height); // NOTE needs to match source for depth blit
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLint previous_framebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, oit.FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, oit.accumulation_texture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, oit.weight_texture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, oit.depth_renderbuffer);
+    constexpr GLenum draw_buffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, draw_buffers);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        error("order-independent transparency framebuffer is not complete");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+}
+
+/**
+ * renders all collected translucent fills into accumulation and weight targets and composites
+ * them over the current framebuffer. opaque geometry is flushed first and its depth is copied
+ * so that translucent fragments behind opaque surfaces are rejected.
+ */
+void PGraphicsOpenGLv33::OIT_resolve() {
+    if (oit_batches.empty()) {
+        return;
+    }
+    RM_flush();
+
+    GLint target_framebuffer;
+    GLint viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target_framebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    OIT_init_buffers(viewport[2], viewport[3]);
+    const GLboolean depth_test_enabled = glIsEnabled(GL_DEPTH_TEST);
+
+    /* accumulate */
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oit.FBO);
+    constexpr GLfloat clear_accumulation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    constexpr GLfloat clear_weight[4]       = {0.0f, 0.0f, 0.0f, 0.0f};
+    glClearBufferfv(GL_COLOR, 0, clear_accumulation);
+    glClearBufferfv(GL_COLOR, 1, clear_weight);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target_framebuffer);
+    glBlitFramebuffer(viewport[0], viewport[1], viewport[0] + viewport[2], viewport[1] + viewport[3],
+                      0, 0, oit.width, oit.height,
+                      GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, oit.FBO);
+    glViewport(0, 0, oit.width, oit.height);
+
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+
+    oit.accumulate_shader->use();
+    OGL3_set_view_projection_matrix(oit.accumulate_shader);
+    oit.accumulate_shader->set_uniform(SHADER_UNIFORM_MODEL_MATRIX, glm::mat4(1.0f)); // NOTE vertices are in world space
+
+    VertexBufferData& vertex_buffer = current_vertex_buffer();
+    if (vertex_buffer.uninitialized()) {
+        OGL3_init_vertex_buffer(vertex_buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer.VBO);
+    const GLint first_vertex      = OGL3_stream_vertex_buffer(vertex_buffer, oit_vertices);
+    const int   tmp_bound_texture = texture_id_current;
+    glBindVertexArray(vertex_buffer.VAO);
+    for (const auto& batch: oit_batches) {
+        IMPL_bind_texture(static_cast<int>(batch.texture_id));
+        glDrawArrays(batch.primitive_mode, first_vertex + batch.start_index, batch.num_vertices);
+    }
+    IMPL_bind_texture(tmp_bound_texture);
+
+    /* composite */
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target_framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glDisable(GL_DEPTH_TEST);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    oit.composite_shader->use();
+    oit.composite_shader->set_uniform("uAccumulation", 0);
+    oit.composite_shader->set_uniform("uWeight", 1);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, oit.weight_texture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, oit.accumulation_texture);
+    glBindVertexArray(oit.VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    /* restore state */
+
+    glBindTexture(GL_TEXTURE_2D, texture_id_current);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glDepthMask(GL_TRUE);
+    if (depth_test_enabled) {
+        glEnable(GL_DEPTH_TEST);
+    }
+    PGraphicsOpenGL::blendMode(blend_mode_current);
+    if (current_shader != nullptr) {
+        current_shader->use();
+    }
+
+    OIT_discard();
+}
+
+void PGraphicsOpenGLv33::OIT_discard() {
+    oit_vertices.clear();
+    oit_batches.clear();
+}
@@ -134,7 +134,11 @@ void PImage::update(PGraphics* graphics, const uint32_t* pixel_data) {
 }
 
 void PImage::updatePixels(PGraphics* graphics) {
-    update(graphics, pixels, static_cast<int>(this->width), static_cast<int>(this->height), 0, 0);
+    if (!pixels) {
+        std::cerr << "pixel array not initialized" << std::endl;
+        return;
+    }
+    update_full_internal(graphics);
 }
 
 void PImage::updatePixels(PGraphics* graphics, const int x, const int y, const int w, const int h) {
@@ -147,14 +151,8 @@ void PImage::updatePixels(PGraphics* graphics, const int x, const int y, const i
         return;
     }
 
-    const int length  = w * h;
-    auto*     mPixels = new uint32_t[length];
-    for (int i = 0; i < length; ++i) {
-        const int src_index = (y + i / w) * static_cast<int>(this->width) + (x + i % w);
-        mPixels[i]          = pixels[src_index];
-    }
-    update(graphics, mPixels, w, h, x, y);
-    delete[] mPixels;
+    // NOTE the region is uploaded straight from `pixels` with rows `width` pixels apart
+    graphics->upload_texture(this, pixels + y * static_cast<int>(this->width) + x, w, h, x, y, true, static_cast<int>(this->width));
 }
 
 /**
@@ -20,6 +20,8 @@
 // ReSharper disable CppCStyleCast
 #include <glm/glm.hpp>
 #include <iostream>
+#include <limits>
+#include <algorithm>
 
 #include "VertexBuffer.h"
 #include "PGraphicsOpenGL.h"
@@ -37,6 +39,9 @@ void VertexBuffer::init() {
 
 VertexBuffer::~VertexBuffer() {
     glDeleteBuffers(1, &vbo);
+    if (ebo != 0) {
+        glDeleteBuffers(1, &ebo);
+    }
     if (vao_supported) {
         glDeleteVertexArrays(1, &vao);
     }
@@ -59,40 +64,97 @@ void VertexBuffer::checkVAOSupport() {
 }
 
 void VertexBuffer::add_vertex(const Vertex& vertex) {
-    dirty = true;
+    mark_dirty(_vertices.size(), 1);
     _vertices.push_back(vertex);
 }
 
 void VertexBuffer::add_vertices(const std::vector<Vertex>& new_vertices) {
-    dirty = true;
+    mark_dirty(_vertices.size(), new_vertices.size());
     _vertices.insert(_vertices.end(), new_vertices.begin(), new_vertices.end());
 }
 
-void VertexBuffer::clear() {
+void VertexBuffer::set_vertex(const size_t index, const Vertex& vertex) {
+    if (index >= _vertices.size()) {
+        return;
+    }
+    _vertices[index] = vertex;
+    mark_dirty(index, 1);
+}
+
+/**
+ * marks a range of vertices as modified e.g after changing `vertices_data()` directly. only dirty
+ * ranges are uploaded with the next `update()` ( or `draw()` ). overlapping and adjacent ranges
+ * are merged, too many ranges are collapsed into one.
+ * @param first_vertex
+ * @param num_vertices
+ */
+void VertexBuffer::mark_dirty(const size_t first_vertex, const size_t num_vertices) {
+    if (num_vertices == 0) {
+        return;
+    }
     dirty = true;
-    _vertices.clear();
+    DirtyRange range{first_vertex, first_vertex + num_vertices};
+    for (auto it = dirty_ranges.begin(); it != dirty_ranges.end();) {
+        if (it->begin <= range.end && range.begin <= it->end) {
+            range.begin = std::min(range.begin, it->begin);
+            range.end   = std::max(range.end, it->end);
+            it          = dirty_ranges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    dirty_ranges.push_back(range);
+    if (dirty_ranges.size() > MAX_DIRTY_RANGES) {
+        for (const auto& r: dirty_ranges) {
+            range.begin = std::min(range.begin, r.begin);
+            range.end   = std::max(range.end, r.end);
+        }
+        dirty_ranges.clear();
+        dirty_ranges.push_back(range);
+    }
 }
 
-void VertexBuffer::resize_buffer() {
-    const size_t client_buffer_size_bytes = _vertices.size() * sizeof(Vertex);
-    const size_t server_buffer_size_bytes = server_buffer_size * sizeof(Vertex);
+void VertexBuffer::add_index(const uint32_t index) {
+    indices_dirty = true;
+    _indices.push_back(index);
+}
 
-    if (client_buffer_size_bytes > server_buffer_size_bytes) {
-        const size_t growSize = client_buffer_size_bytes + VBO_BUFFER_CHUNK_SIZE_BYTES;
-        // std::cout << "Growing vertex buffer from " << server_buffer_size_bytes << " to " << growSize << " bytes" << std::endl;
-        glBindBuffer(GL_ARRAY_BUFFER, vbo); // Ensure VBO is bound
-        glBufferData(GL_ARRAY_BUFFER, growSize, _vertices.data(), GL_DYNAMIC_DRAW);
-        server_buffer_size = growSize / sizeof(Vertex);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+void VertexBuffer::add_indices(const std::vector<uint32_t>& new_indices) {
+    indices_dirty = true;
+    _indices.insert(_indices.end(), new_indices.begin(), new_indices.end());
+}
+
+void VertexBuffer::clear() {
+    dirty = true;
+    dirty_ranges.clear();
+    _vertices.clear();
+    if (!_indices.empty()) {
+        indices_dirty = true;
+        _indices.clear();
     }
-    if (client_buffer_size_bytes < server_buffer_size_bytes) {
-        const size_t shrinkSize = client_buffer_size_bytes;
-        // std::cout << "Shrinking vertex buffer to " << client_buffer_size_bytes << " bytes" << std::endl;
-        glBindBuffer(GL_ARRAY_BUFFER, vbo); // Ensure VBO is bound
-        glBufferData(GL_ARRAY_BUFFER, shrinkSize, _vertices.data(), GL_DYNAMIC_DRAW);
-        server_buffer_size = shrinkSize / sizeof(Vertex);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ * reallocates server buffer if the client buffer outgrew it ( geometric growth ) or if it shrank
+ * well below its capacity ( hysteresis ) and uploads all vertices. buffer needs to be bound.
+ * @return true if the buffer was reallocated
+ */
+bool VertexBuffer::resize_buffer() {
+    const size_t num_vertices = _vertices.size();
+    size_t       new_capacity;
+    if (num_vertices > server_buffer_size) {
+        new_capacity = std::max(num_vertices, server_buffer_size + server_buffer_size / 2);
+    } else if (num_vertices < server_buffer_size / 4 && server_buffer_size > VBO_BUFFER_CHUNK_SIZE_VERTICES) {
+        new_capacity = std::max(num_vertices * 2, VBO_BUFFER_CHUNK_SIZE_VERTICES);
+    } else {
+        return false;
     }
+    // std::cout << "Resizing vertex buffer from " << server_buffer_size << " to " << new_capacity << " vertices" << std::endl;
+    glBufferData(GL_ARRAY_BUFFER, new_capacity * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, num_vertices * sizeof(Vertex), _vertices.data());
+    server_buffer_size = new_capacity;
+    dirty_ranges.clear();
+    return true;
 }
 
 void VertexBuffer::upload() {
@@ -133,6 +195,45 @@ void VertexBuffer::upload() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     server_buffer_size = _vertices.size();
+    dirty_ranges.clear();
+}
+
+/**
+ * uploads indices to element array buffer. indices are stored as 16-bit values if the largest
+ * index allows it. NOTE element array buffer binding is part of the VAO state.
+ */
+void VertexBuffer::upload_indices() {
+    if (_indices.empty()) {
+        return;
+    }
+
+    if (ebo == 0) {
+        glGenBuffers(1, &ebo);
+    }
+
+    uint32_t max_index = 0;
+    for (const uint32_t i: _indices) {
+        max_index = std::max(max_index, i);
+    }
+
+    if (vao_supported) {
+        glBindVertexArray(vao);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    if (max_index <= std::numeric_limits<uint16_t>::max()) {
+        index_type = GL_UNSIGNED_SHORT;
+        _indices_16.assign(_indices.begin(), _indices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indices_16.size() * sizeof(uint16_t), _indices_16.data(), GL_STATIC_DRAW);
+    } else {
+        index_type = GL_UNSIGNED_INT;
+        _indices_16.clear();
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indices.size() * sizeof(uint32_t), _indices.data(), GL_STATIC_DRAW);
+    }
+    if (vao_supported) {
+        glBindVertexArray(0);
+    } else {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
 }
 
 void VertexBuffer::draw() {
@@ -146,11 +247,19 @@ void VertexBuffer::draw() {
         dirty = false;
         update();
     }
+    if (indices_dirty) {
+        indices_dirty = false;
+        upload_indices();
+    }
     const int mode = get_draw_mode(shape);
 
     if (vao_supported) {
         glBindVertexArray(vao);
-        glDrawArrays(mode, 0, _vertices.size());
+        if (indexed()) {
+            glDrawElements(mode, _indices.size(), index_type, nullptr);
+        } else {
+            glDrawArrays(mode, 0, _vertices.size());
+        }
         glBindVertexArray(0);
     } else {
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -164,7 +273,13 @@ void VertexBuffer::draw() {
         glEnableVertexAttribArray(2);
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, tex_coord));
 
-        glDrawArrays(mode, 0, _vertices.size());
+        if (indexed()) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+            glDrawElements(mode, _indices.size(), index_type, nullptr);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        } else {
+            glDrawArrays(mode, 0, _vertices.size());
+        }
 
         glDisableVertexAttribArray(0);
         glDisableVertexAttribArray(1);
@@ -173,6 +288,61 @@ void VertexBuffer::draw() {
     }
 }
 
+/**
+ * draws the mesh `num_instances` times with one draw call. per-instance attributes ( `InstanceData` )
+ * are read from `instance_vbo` at locations 4–7 ( model matrix ) and 8 ( color ).
+ * @param instance_vbo
+ * @param num_instances
+ */
+void VertexBuffer::draw_instanced(const GLuint instance_vbo, const int num_instances) {
+    if (!buffer_initialized) { init(); }
+
+    if (_vertices.empty() || num_instances <= 0) {
+        return;
+    }
+
+    if (!vao_supported) {
+        warning("instanced drawing requires vertex array objects");
+        return;
+    }
+
+    if (dirty) {
+        dirty = false;
+        update();
+    }
+    if (indices_dirty) {
+        indices_dirty = false;
+        upload_indices();
+    }
+
+    glBindVertexArray(vao);
+    if (instance_vbo_attached != instance_vbo) {
+        // NOTE instance attributes are stored in VAO i.e only need to be set up once per instance buffer
+        instance_vbo_attached = instance_vbo;
+        constexpr int ATTRIBUTE_LOCATION_INSTANCE_MODEL_MATRIX = 4; // NOTE occupies locations 4–7
+        constexpr int ATTRIBUTE_LOCATION_INSTANCE_COLOR        = 8;
+        constexpr int ATTRIBUTE_SIZE_INSTANCE_COLUMN           = 4;
+        glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
+        for (int i = 0; i < 4; ++i) {
+            const int location = ATTRIBUTE_LOCATION_INSTANCE_MODEL_MATRIX + i;
+            glVertexAttribPointer(location, ATTRIBUTE_SIZE_INSTANCE_COLUMN, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  reinterpret_cast<void*>(offsetof(InstanceData, model_matrix) + sizeof(glm::vec4) * i));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+        glVertexAttribPointer(ATTRIBUTE_LOCATION_INSTANCE_COLOR, ATTRIBUTE_SIZE_INSTANCE_COLUMN, GL_FLOAT, GL_FALSE, sizeof(InstanceData), reinterpret_cast<void*>(offsetof(InstanceData, color)));
+        glEnableVertexAttribArray(ATTRIBUTE_LOCATION_INSTANCE_COLOR);
+        glVertexAttribDivisor(ATTRIBUTE_LOCATION_INSTANCE_COLOR, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    if (indexed()) {
+        glDrawElementsInstanced(get_draw_mode(shape), _indices.size(), index_type, nullptr, num_instances);
+    } else {
+        glDrawArraysInstanced(get_draw_mode(shape), 0, _vertices.size(), num_instances);
+    }
+    glBindVertexArray(0);
+}
+
 void VertexBuffer::update() {
     if (!buffer_initialized) { init(); }
 
@@ -186,12 +356,25 @@ void VertexBuffer::update() {
         return;
     }
 
+    // NOTE an explicit `update()` without marked ranges ( e.g after editing `vertices_data()` ) uploads everything
+    if (dirty_ranges.empty()) {
+        mark_dirty(0, _vertices.size());
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    if (_vertices.size() > server_buffer_size ||
-        _vertices.size() + VBO_BUFFER_CHUNK_SIZE_BYTES / sizeof(Vertex) < server_buffer_size) {
-        resize_buffer();
-    } else {
-        glBufferSubData(GL_ARRAY_BUFFER, 0, _vertices.size() * sizeof(Vertex), _vertices.data());
+    if (!resize_buffer()) {
+        for (const auto& range: dirty_ranges) {
+            const size_t end = std::min(range.end, _vertices.size());
+            if (range.begin >= end) {
+                continue;
+            }
+            glBufferSubData(GL_ARRAY_BUFFER,
+                            range.begin * sizeof(Vertex),
+                            (end - range.begin) * sizeof(Vertex),
+                            _vertices.data() + range.begin);
+        }
+        dirty_ranges.clear();
     }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    dirty = false;
 }
@@ -1,7 +1,10 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 
+#include "UmfeldConstants.h"
 #include "UmfeldFunctionsAdditional.h"
 #include "PShader.h"
 
@@ -33,6 +36,7 @@ bool PShader::load(const std::string& vertex_code, const std::string& fragment_c
 
     glLinkProgram(programID);
     checkLinkErrors(programID);
+    resolve_uniforms();
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
@@ -81,7 +85,69 @@ void PShader::checkLinkErrors(const GLuint program) {
     }
 }
 
-GLint PShader::getUniformLocation(const std::string& name) {
+void PShader::resolve_uniforms() {
+    uniforms.clear();
+    uniform_indices.clear();
+    has_matrix_block = false;
+    if (!programID) { return; }
+
+    GLint num_uniforms = 0;
+    GLint max_length   = 0;
+    glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &num_uniforms);
+    glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+    std::vector<GLchar> name_buffer(std::max(max_length, 1));
+    for (GLint i = 0; i < num_uniforms; ++i) {
+        GLsizei length = 0;
+        GLint   size   = 0;
+        GLenum  type   = 0;
+        glGetActiveUniform(programID, i, static_cast<GLsizei>(name_buffer.size()), &length, &size, &type, name_buffer.data());
+        std::string name(name_buffer.data(), length);
+        // NOTE arrays are reported as `name[0]` but may be set by `name`
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            name.resize(name.size() - 3);
+        }
+        const GLint location = glGetUniformLocation(programID, name.c_str());
+        if (location < 0) {
+            continue; // NOTE uniforms inside a uniform block have no location
+        }
+        register_uniform(name, location);
+    }
+
+    const GLuint block_index = glGetUniformBlockIndex(programID, SHADER_UNIFORM_BLOCK_MATRICES.c_str());
+    if (block_index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(programID, block_index, SHADER_UNIFORM_BLOCK_MATRICES_BINDING);
+        has_matrix_block = true;
+    }
+}
+
+int PShader::register_uniform(const std::string& name, const GLint location) {
+    const int index = static_cast<int>(uniforms.size());
+    uniforms.push_back({location});
+    uniform_indices[name] = index;
+    return index;
+}
+
+PShader::UniformHandle PShader::get_uniform_handle(const std::string& name) {
+    const auto it = uniform_indices.find(name);
+    if (it != uniform_indices.end()) {
+        return {it->second};
+    }
+    if (!programID) { return {}; }
+    // NOTE array elements ( e.g `values[2]` ) and struct members are not enumerated by `resolve_uniforms`
+    const GLint location = glGetUniformLocation(programID, name.c_str());
+    if (location >= 0) {
+        return {register_uniform(name, location)};
+    }
+    // NOTE unknown uniforms are registered with an invalid location so that the warning is only emitted once
+    warning("Shader uniform '", name, "' was not found or is not used. this might be intentional or maybe the uniform name is misspelled.");
+    return {register_uniform(name, -1)};
+}
+
+/**
+ * @return uniform if `value` differs from the shadowed value ( and updates the shadow ) or `nullptr` if
+ *         the GL call can be skipped
+ */
+PShader::Uniform* PShader::changed_uniform(const UniformHandle handle, const void* value, const size_t size) {
 #ifdef DEBUG_SHADER_PROGRAM_ID
     GLint currentlyBoundProgram;
     glGetIntegerv(GL_CURRENT_PROGRAM, &currentlyBoundProgram);
@@ -90,53 +156,93 @@ GLint PShader::getUniformLocation(const std::string& name) {
                   << " expected " << programID << ", got " << currentlyBoundProgram << std::endl;
     }
 #endif
-    if (!programID) { return 0; }
-    if (uniformLocations.find(name) == uniformLocations.end()) {
-        uniformLocations[name] = glGetUniformLocation(programID, name.c_str());
-        // console("uniformLocations[name]: ", name, " = ", uniformLocations[name]);
-        if (uniformLocations[name] < 0) {
-            warning("Shader uniform '", name, "' was not found or is not used. this might be intentional or maybe the uniform name is misspelled.");
-        }
+    if (!programID || handle.index < 0 || handle.index >= static_cast<int>(uniforms.size())) { return nullptr; }
+    Uniform& uniform = uniforms[handle.index];
+    if (uniform.location < 0) { return nullptr; }
+    if (uniform.has_value && std::memcmp(uniform.value.data(), value, size) == 0) { return nullptr; }
+    std::memcpy(uniform.value.data(), value, size);
+    uniform.has_value = true;
+    return &uniform;
+}
+
+void PShader::set_uniform(const UniformHandle handle, const int value) {
+    if (const Uniform* uniform = changed_uniform(handle, &value, sizeof(value))) {
+        glUniform1i(uniform->location, value);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const int value_a, const int value_b) {
+    const int value[2] = {value_a, value_b};
+    if (const Uniform* uniform = changed_uniform(handle, value, sizeof(value))) {
+        glUniform2i(uniform->location, value_a, value_b);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const float value) {
+    if (const Uniform* uniform = changed_uniform(handle, &value, sizeof(value))) {
+        glUniform1f(uniform->location, value);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const float value_a, const float value_b) {
+    const float value[2] = {value_a, value_b};
+    if (const Uniform* uniform = changed_uniform(handle, value, sizeof(value))) {
+        glUniform2f(uniform->location, value_a, value_b);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const glm::vec2& value) {
+    if (const Uniform* uniform = changed_uniform(handle, &value[0], sizeof(value))) {
+        glUniform2fv(uniform->location, 1, &value[0]);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const glm::vec3& value) {
+    if (const Uniform* uniform = changed_uniform(handle, &value[0], sizeof(value))) {
+        glUniform3fv(uniform->location, 1, &value[0]);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const glm::vec4& value) {
+    if (const Uniform* uniform = changed_uniform(handle, &value[0], sizeof(value))) {
+        glUniform4fv(uniform->location, 1, &value[0]);
+    }
+}
+
+void PShader::set_uniform(const UniformHandle handle, const glm::mat4& value) {
+    if (const Uniform* uniform = changed_uniform(handle, &value[0][0], sizeof(value))) {
+        glUniformMatrix4fv(uniform->location, 1, GL_FALSE, &value[0][0]);
     }
-    return uniformLocations[name];
 }
 
 void PShader::set_uniform(const std::string& name, const int value) {
-    if (!programID) { return; }
-    glUniform1i(getUniformLocation(name), value);
+    set_uniform(get_uniform_handle(name), value);
 }
 
 void PShader::set_uniform(const std::string& name, const int value_a, const int value_b) {
-    if (!programID) { return; }
-    glUniform2i(getUniformLocation(name), value_a, value_b);
+    set_uniform(get_uniform_handle(name), value_a, value_b);
 }
 
 void PShader::set_uniform(const std::string& name, const float value) {
-    if (!programID) { return; }
-    glUniform1f(getUniformLocation(name), value);
+    set_uniform(get_uniform_handle(name), value);
 }
 
 void PShader::set_uniform(const std::string& name, const float value_a, const float value_b) {
-    if (!programID) { return; }
-    glUniform2f(getUniformLocation(name), value_a, value_b);
+    set_uniform(get_uniform_handle(name), value_a, value_b);
 }
 
 void PShader::set_uniform(const std::string& name, const glm::vec2& value) {
-    if (!programID) { return; }
-    glUniform2fv(getUniformLocation(name), 1, &value[0]);
+    set_uniform(get_uniform_handle(name), value);
 }
 
 void PShader::set_uniform(const std::string& name, const glm::vec3& value) {
-    if (!programID) { return; }
-    glUniform3fv(getUniformLocation(name), 1, &value[0]);
+    set_uniform(get_uniform_handle(name), value);
 }
 
 void PShader::set_uniform(const std::string& name, const glm::vec4& value) {
-    if (!programID) { return; }
-    glUniform4fv(getUniformLocation(name), 1, &value[0]);
+    set_uniform(get_uniform_handle(name), value);
 }
 
 void PShader::set_uniform(const std::string& name, const glm::mat4& value) {
-    if (!programID) { return; }
-    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &value[0][0]);
-}
\ No newline at end of file
+    set_uniform(get_uniform_handle(name), value);
+}
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <portaudio.h>
 #include <chrono>
+#include <cstring>
 #include <thread>
 
 #include "UmfeldFunctionsAdditional.h"
@@ -53,10 +54,8 @@ namespace umfeld {
         explicit PAudioPortAudio(PAudio* audio) : audio(audio),
                                                   update_interval((audio->buffer_size * 1000) / audio->sample_rate) {
             this->audio = audio;
-            if (!init()) {
-                error("PAudioPortAudio: could not intialize");
-                return;
-            }
+            threaded    = run_audio_in_thread;
+            // NOTE buffers are allocated before the stream is started as the audio callback might be called right away
             if (audio->input_channels > 0) {
                 audio->input_buffer = new float[audio->buffer_size * audio->input_channels]{0};
             } else {
@@ -67,6 +66,10 @@ namespace umfeld {
             } else {
                 audio->output_buffer = nullptr;
             }
+            if (!init()) {
+                error("PAudioPortAudio: could not intialize");
+                return;
+            }
         }
 
         void start() {
@@ -99,6 +102,10 @@ namespace umfeld {
                 return;
             }
 
+            if (threaded) {
+                return; // NOTE audio is processed in `audio_callback` on the audio thread
+            }
+
             const auto now = std::chrono::high_resolution_clock::now();
             if (now - last_audio_update >= update_interval) {
                 // check if input is available
@@ -117,10 +124,7 @@ namespace umfeld {
                 // call audioevent resepcting non-present audio devices and available frames
                 if ((availableInputFrames >= audio->buffer_size || audio->input_channels == 0) &&
                     (availableOutputFrames >= audio->buffer_size || audio->output_channels == 0)) {
-                    if (a != nullptr && audio == umfeld::a) {
-                        audioEvent();
-                    }
-                    audioEvent(*audio);
+                    dispatch_audio_event(audio);
                 }
 
                 if (availableOutputFrames >= audio->buffer_size) {
@@ -146,9 +150,66 @@ namespace umfeld {
 
     private:
         bool                                                        isPaused = false;
+        bool                                                        threaded = false;
         std::chrono::milliseconds                                   update_interval;
         std::chrono::time_point<std::chrono::high_resolution_clock> last_audio_update;
 
+        static void dispatch_audio_event(PAudio* audio) {
+            if (a != nullptr && audio == umfeld::a) {
+                audioEvent();
+            }
+            audioEvent(*audio);
+        }
+
+        /**
+         * called by PortAudio on its real-time audio thread for every buffer. the main loop and
+         * `draw()` are not involved, so a slow frame no longer causes audio dropouts. nothing in here
+         * may block i.e no locks, allocations or console output.
+         */
+        static int audio_callback(const void*                     input,
+                                  void*                           output,
+                                  const unsigned long             frame_count,
+                                  const PaStreamCallbackTimeInfo* time_info,
+                                  const PaStreamCallbackFlags     status_flags,
+                                  void*                           user_data) {
+            const auto* device = static_cast<PAudioPortAudio*>(user_data);
+            PAudio*     audio  = device->audio;
+
+            if (status_flags & (paInputUnderflow | paInputOverflow | paOutputUnderflow | paOutputOverflow)) {
+                audio->report_xrun();
+            }
+
+            const size_t num_output_samples = frame_count * audio->output_channels;
+            if (frame_count != static_cast<unsigned long>(audio->buffer_size)) {
+                // NOTE should not happen as the stream is opened with a fixed number of frames per buffer
+                if (output != nullptr) {
+                    std::memset(output, 0, num_output_samples * sizeof(float));
+                }
+                audio->report_xrun();
+                return paContinue;
+            }
+
+            if (input != nullptr && audio->input_buffer != nullptr) {
+                std::memcpy(audio->input_buffer, input, frame_count * audio->input_channels * sizeof(float));
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            dispatch_audio_event(audio);
+            const std::chrono::duration<double> processing_time = std::chrono::steady_clock::now() - start;
+            if (processing_time.count() > static_cast<double>(frame_count) / audio->sample_rate) {
+                audio->report_xrun();
+            }
+
+            if (output != nullptr) {
+                if (audio->output_buffer != nullptr) {
+                    std::memcpy(output, audio->output_buffer, num_output_samples * sizeof(float));
+                } else {
+                    std::memset(output, 0, num_output_samples * sizeof(float));
+                }
+            }
+            return paContinue;
+        }
+
         int find_logical_device_id_by_name(const std::vector<AudioDevice>& devices, const std::string& name) const {
             for (int i = 0; i < devices.size(); i++) {
                 if (begins_with(devices[i].name, name)) {
@@ -283,9 +344,9 @@ namespace umfeld {
                 audio->output_channels > 0 ? &outputParams : nullptr,
                 audio->sample_rate,
                 audio->buffer_size,
-                paClipOff, // No clipping
-                nullptr,   // No callback (blocking mode)
-                nullptr    // No user data
+                paClipOff,                           // No clipping
+                threaded ? audio_callback : nullptr, // No callback (blocking mode) unless audio runs in own thread
+                threaded ? this : nullptr            // User data for callback
             );
 
             if (err != paNoError) {
@@ -295,14 +356,29 @@ namespace umfeld {
                 return false;
             }
 
-            Pa_StartStream(stream);
+            if (!threaded) {
+                Pa_StartStream(stream); // NOTE in threaded mode the stream is started after `setup()`
+            }
             last_audio_update = std::chrono::high_resolution_clock::now();
 
             return true;
         }
     };
 
-    static void setup_post() {}
+    static void start_audio_devices() {
+        for (const auto _device: audio_devices) {
+            if (_device != nullptr) {
+                _device->start();
+            }
+        }
+    }
+
+    static void setup_post() {
+        if (run_audio_in_thread) {
+            // NOTE `audioEvent` must not be called from the audio thread before `setup()` is done
+            start_audio_devices();
+        }
+    }
     static void draw_pre() {}
     static void draw_post() {}
     static void event(SDL_Event* event) {}
@@ -396,10 +472,8 @@ namespace umfeld {
     }
 
     static void setup_pre() {
-        for (const auto _device: audio_devices) {
-            if (_device != nullptr) {
-                _device->start();
-            }
+        if (!run_audio_in_thread) {
+            start_audio_devices();
         }
     }
 
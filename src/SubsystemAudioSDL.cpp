@@ -17,6 +17,9 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <chrono>
+#include <cstring>
+
 #include "Umfeld.h"
 #include "Subsystems.h"
 #include "PAudio.h"
@@ -28,6 +31,7 @@ namespace umfeld {
         SDL_AudioStream* sdl_input_stream{nullptr};
         int              logical_output_device_id{0};
         SDL_AudioStream* sdl_output_stream{nullptr};
+        bool             threaded{false}; // NOTE audio is processed in stream callbacks on the audio thread
     };
 
     struct AudioUnitInfoSDL : AudioUnitInfo {
@@ -35,10 +39,9 @@ namespace umfeld {
     };
 
     static std::vector<PAudioSDL*> _audio_devices;
-    // TODO callback mode is not working well.
-    //      also it appears to be slightly deprecated by SDL devs.
-    //      maybe drop it at some point ...
-    // static bool _audio_device_callback_mode = false;
+    // NOTE if `run_audio_in_thread` is set audio is processed in stream callbacks ( see `output_stream_callback` )
+    //      otherwise streams are polled from the main loop in `update_loop`.
+    static constexpr int max_queued_input_blocks = 4; // NOTE input beyond this is dropped to keep the latency bounded
 
     static const char* name() {
         return "SDL Audio";
@@ -331,11 +334,119 @@ namespace umfeld {
         }
     }
 
+    static void dispatch_audio_event(PAudio* device) {
+        // NOTE for main audio device
+        if (a != nullptr) {
+            if (device == a) {
+                audioEvent();
+            }
+        }
+
+        // NOTE for all registered audio devices ( including main audio device )
+        audioEvent(*device);
+    }
+
+    /* --- audio thread --- */
+
+    static void process_audio_block(PAudio* device) {
+        const auto start = std::chrono::steady_clock::now();
+        dispatch_audio_event(device);
+        const std::chrono::duration<double> processing_time = std::chrono::steady_clock::now() - start;
+        if (processing_time.count() > static_cast<double>(device->buffer_size) / device->sample_rate) {
+            device->report_xrun(); // NOTE the block took longer to compute than to play
+        }
+    }
+
+    static bool read_input_block(const PAudioSDL* _device) {
+        PAudio*          device = _device->audio_device;
+        SDL_AudioStream* stream = _device->sdl_input_stream;
+        if (stream == nullptr || device->input_buffer == nullptr) {
+            return false;
+        }
+        const int num_block_bytes = device->buffer_size * device->input_channels * static_cast<int>(sizeof(float));
+        if (num_block_bytes <= 0) {
+            return false;
+        }
+        if (SDL_GetAudioStreamAvailable(stream) >= max_queued_input_blocks * num_block_bytes) {
+            while (SDL_GetAudioStreamAvailable(stream) >= 2 * num_block_bytes) {
+                SDL_GetAudioStreamData(stream, device->input_buffer, num_block_bytes);
+            }
+            device->report_xrun(); // NOTE input overflow
+        }
+        if (SDL_GetAudioStreamAvailable(stream) < num_block_bytes) {
+            return false;
+        }
+        return SDL_GetAudioStreamData(stream, device->input_buffer, num_block_bytes) == num_block_bytes;
+    }
+
+    /**
+     * called by SDL on the audio device thread whenever the output stream needs more samples. the
+     * main loop and `draw()` are not involved. nothing in here may block i.e no locks, allocations
+     * or console output.
+     */
+    static void SDLCALL output_stream_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount) {
+        const auto* _device         = static_cast<PAudioSDL*>(userdata);
+        PAudio*     device          = _device->audio_device;
+        const int   num_block_bytes = device->buffer_size * device->output_channels * static_cast<int>(sizeof(float));
+        if (num_block_bytes <= 0 || device->output_buffer == nullptr) {
+            return;
+        }
+        while (additional_amount > 0) {
+            if (device->input_buffer != nullptr && !read_input_block(_device)) {
+                std::memset(device->input_buffer, 0, device->buffer_size * device->input_channels * sizeof(float));
+            }
+            process_audio_block(device);
+            SDL_PutAudioStreamData(stream, device->output_buffer, num_block_bytes);
+            additional_amount -= num_block_bytes;
+        }
+    }
+
+    /**
+     * called by SDL on the audio device thread whenever a recording device delivered samples. only
+     * used for devices without output, otherwise input is read in `output_stream_callback`.
+     */
+    static void SDLCALL input_stream_callback(void* userdata, SDL_AudioStream* stream, int additional_amount, int total_amount) {
+        const auto* _device = static_cast<PAudioSDL*>(userdata);
+        while (read_input_block(_device)) {
+            process_audio_block(_device->audio_device);
+        }
+    }
+
+    static void setup_post() {
+        if (!run_audio_in_thread) {
+            return;
+        }
+        // NOTE callbacks are installed after `setup()` so that `audioEvent` never runs before it
+        for (const auto _device: _audio_devices) {
+            if (_device == nullptr || _device->audio_device == nullptr) {
+                continue;
+            }
+            if (_device->sdl_input_stream != nullptr) {
+                SDL_ClearAudioStream(_device->sdl_input_stream); // NOTE drop input recorded before `setup()` was done
+            }
+            if (_device->sdl_output_stream != nullptr) {
+                if (!SDL_SetAudioStreamGetCallback(_device->sdl_output_stream, output_stream_callback, _device)) {
+                    error("could not set audio output stream callback: ", SDL_GetError());
+                    continue;
+                }
+            } else if (_device->sdl_input_stream != nullptr) {
+                if (!SDL_SetAudioStreamPutCallback(_device->sdl_input_stream, input_stream_callback, _device)) {
+                    error("could not set audio input stream callback: ", SDL_GetError());
+                    continue;
+                }
+            }
+            _device->threaded = true;
+        }
+    }
+
+    /* --- main loop --- */
+
     static void update_loop() {
         // NOTE consult https://wiki.libsdl.org/SDL3/Tutorials/AudioStream
         for (const auto _device: _audio_devices) {
             if (_device != nullptr &&
-                _device->audio_device != nullptr) {
+                _device->audio_device != nullptr &&
+                !_device->threaded) {
 
                 const int _num_sample_frames = _device->audio_device->buffer_size;
 
@@ -367,15 +478,7 @@ namespace umfeld {
                         if (!SDL_AudioStreamDevicePaused(_stream)) {
                             const int request_num_sample_frames = _device->audio_device->buffer_size;
                             if (SDL_GetAudioStreamQueued(_stream) < request_num_sample_frames) {
-                                // NOTE for main audio device
-                                if (a != nullptr) {
-                                    if (_device->audio_device == a) {
-                                        audioEvent();
-                                    }
-                                }
-
-                                // NOTE for all registered audio devices ( including main audio device )
-                                audioEvent(*_device->audio_device);
+                                dispatch_audio_event(_device->audio_device);
 
                                 const int    num_processed_bytes = static_cast<int>(_num_sample_frames) * _device->audio_device->output_channels * sizeof(float);
                                 const float* buffer              = _device->audio_device->output_buffer;
@@ -581,6 +684,7 @@ umfeld::SubsystemAudio* umfeld_create_subsystem_audio_sdl() {
     auto* audio         = new umfeld::SubsystemAudio{};
     audio->set_flags    = umfeld::set_flags;
     audio->init         = umfeld::init;
+    audio->setup_post   = umfeld::setup_post;
     audio->update_loop  = umfeld::update_loop;
     audio->shutdown     = umfeld::shutdown;
     audio->name         = umfeld::name;
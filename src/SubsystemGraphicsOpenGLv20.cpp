@@ -63,6 +63,9 @@ namespace umfeld {
 
     static void set_flags(uint32_t& subsystem_flags) {
         subsystem_flags |= SDL_INIT_VIDEO;
+        if (headless) {
+            warning("headless rendering is only supported by the OpenGL 3.3 renderer.");
+        }
     }
 
     // ReSharper disable once CppParameterMayBeConstPtrOrRef
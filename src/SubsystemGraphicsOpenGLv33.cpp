@@ -58,12 +58,20 @@ namespace umfeld {
     }
 
     static void shutdown() {
+        if (g != nullptr) {
+            g->finish_framebuffer_readbacks(); // NOTE requires the context
+        }
         SDL_GL_DestroyContext(gl_context);
         SDL_DestroyWindow(window);
     }
 
     static void set_flags(uint32_t& subsystem_flags) {
         subsystem_flags |= SDL_INIT_VIDEO;
+        if (headless) {
+            // NOTE the offscreen video driver creates an EGL context without display ( e.g Mesa llvmpipe
+            //      on servers without GPU ). `LIBGL_ALWAYS_SOFTWARE=1` forces software rendering.
+            SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        }
     }
 
     // ReSharper disable once CppParameterMayBeConstPtrOrRef
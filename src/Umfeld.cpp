@@ -20,6 +20,7 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
 
+#include <cmath>
 #include <iostream>
 #include <string>
 
@@ -281,7 +282,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
     if (umfeld::enable_graphics) {
         if (umfeld::subsystem_graphics != nullptr) {
             if (umfeld::subsystem_graphics->create_native_graphics != nullptr) {
-                umfeld::g = umfeld::subsystem_graphics->create_native_graphics(umfeld::render_to_buffer);
+                umfeld::g = umfeld::subsystem_graphics->create_native_graphics(umfeld::render_to_buffer || umfeld::headless); // NOTE headless rendering requires the offscreen framebuffer
             }
         }
     }
@@ -459,7 +460,15 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
         }
     }
 
-    if (frame_duration >= umfeld::target_frame_duration) {
+    if (umfeld::fixed_timestep) {
+        // NOTE frames do not wait for the clock and time advances by exactly one frame. this makes
+        //      output driven by `frameCount`, `frameRate` or `millis()` reproducible
+        handle_draw();
+        umfeld::fixed_timestep_ns += std::llround(umfeld::target_frame_duration * 1.0e9); // NOTE integer nanoseconds do not drift, changing the frame rate keeps time continuous
+        umfeld::frameRate = static_cast<float>(1.0 / umfeld::target_frame_duration);
+        umfeld::frameCount++;
+        umfeld::lastFrameTime = currentFrameTime;
+    } else if (frame_duration >= umfeld::target_frame_duration) {
         handle_draw();
 
         if (frame_duration == 0) {
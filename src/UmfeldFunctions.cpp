@@ -32,6 +32,7 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 #include "tinyfiledialogs.h"
+#include "ImageEncoder.h"
 
 #include "Umfeld.h"
 #include "SimplexNoise.h"
@@ -613,6 +614,9 @@ namespace umfeld {
 
     // Returns the number of milliseconds since the program started
     long long millis() {
+        if (fixed_timestep) {
+            return fixed_timestep_ns / 1000000; // NOTE time of the current frame, independent of `frameRate`
+        }
         static auto start_time = steady_clock::now();
         return duration_cast<milliseconds>(steady_clock::now() - start_time).count();
     }
@@ -653,42 +657,32 @@ namespace umfeld {
 
     void noCursor() { SDL_HideCursor(); }
 
+    /**
+     * encoder shared by all `saveFrame` calls. queued images are written before the application exits.
+     */
+    static ImageEncoder& frame_encoder() {
+        static ImageEncoder encoder;
+        return encoder;
+    }
+
     void saveFrame(const std::string& filename) {
         if (g == nullptr) {
             return;
         }
 
-        const int _height = g->framebuffer.height;
-        const int _width  = g->framebuffer.width;
+        if (!ImageEncoder::is_supported(filename)) {
+            warning("Unsupported file format: ", filename, ". Supported formats are: .png, .jpg, .bmp, .tga");
+            return;
+        }
 
-        // Allocate memory for pixel data (RGBA)
-        std::vector<unsigned char> pixels;
-        // glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
-        const bool success = g->read_framebuffer(pixels);
+        // NOTE pixels are read asynchronously and encoded on a background thread. images are flipped
+        //      vertically because OpenGL's origin is bottom-left
+        const bool success = g->read_framebuffer_async([filename](std::vector<unsigned char>& pixels, const int width, const int height) {
+            frame_encoder().encode(filename, width, height, std::move(pixels), true);
+        });
         if (!success) {
             warning("could not read pixel from color buffer. not saving image. try turning of anti-aliasing or offscreen rendering.");
         }
-
-        // Flip the image vertically because OpenGL's origin is bottom-left
-        std::vector<unsigned char> flippedPixels(_width * _height * DEFAULT_BYTES_PER_PIXELS);
-        for (int y = 0; y < _height; ++y) {
-            memcpy(&flippedPixels[(_height - 1 - y) * _width * DEFAULT_BYTES_PER_PIXELS], &pixels[y * _width * DEFAULT_BYTES_PER_PIXELS], _width * DEFAULT_BYTES_PER_PIXELS);
-        }
-
-        // save image
-        if (ends_with(filename, ".png")) {
-            stbi_write_png(filename.c_str(), _width, _height, DEFAULT_BYTES_PER_PIXELS, flippedPixels.data(), _width * 4);
-        } else if (ends_with(filename, ".jpg")) {
-            stbi_write_jpg(filename.c_str(), _width, _height, DEFAULT_BYTES_PER_PIXELS, flippedPixels.data(), 100);
-        } else if (ends_with(filename, ".bmp")) {
-            stbi_write_bmp(filename.c_str(), _width, _height, DEFAULT_BYTES_PER_PIXELS, flippedPixels.data());
-        } else if (ends_with(filename, ".tga")) {
-            stbi_write_tga(filename.c_str(), _width, _height, DEFAULT_BYTES_PER_PIXELS, flippedPixels.data());
-            // } else if (ends_with(filename, ".hdr")) {
-            //     stbi_write_hdr((filename).c_str(), _width, _height, DEFAULT_BYTES_PER_PIXELS, reinterpret_cast<float*>(flippedPixels.data()));
-        } else {
-            warning("Unsupported file format: ", filename, ". Supported formats are: .png, .jpg, .bmp, .tga");
-        }
     }
 
     void saveFrame() {
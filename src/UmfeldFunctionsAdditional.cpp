@@ -18,6 +18,7 @@
  */
 
 #include <filesystem>
+#include <unordered_map>
 
 #if defined(__APPLE__) || defined(__linux__)
 #include <dlfcn.h>
@@ -357,6 +358,114 @@ namespace umfeld {
         return material ? loadOBJ_with_material(filename) : loadOBJ_no_material(filename);
     }
 
+    /**
+     * loads an OBJ file as indexed triangles. face corners that share the same position, normal,
+     * texture coordinate and material ( or vertex color ) are welded into a single vertex.
+     *
+     * @param filename
+     * @param vertices unique vertices ( cleared first )
+     * @param indices three indices per triangle ( cleared first )
+     * @param material use diffuse material color ( `true` ) or vertex color ( `false` )
+     * @return true if the file was loaded
+     */
+    bool loadOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const bool material) {
+        vertices.clear();
+        indices.clear();
+
+        tinyobj::ObjReader       reader;
+        tinyobj::ObjReaderConfig config;
+        config.triangulate = true;
+
+        if (!reader.ParseFromFile(filename, config)) {
+            error("failed to load OBJ: ", reader.Error());
+            return false;
+        }
+        if (!reader.Warning().empty()) {
+            warning("OBJ loader: ", reader.Warning());
+        }
+
+        const auto& attrib    = reader.GetAttrib();
+        const auto& shapes    = reader.GetShapes();
+        const auto& materials = reader.GetMaterials();
+
+        struct CornerKey {
+            int vertex_index;
+            int normal_index;
+            int texcoord_index;
+            int material_id;
+            bool operator==(const CornerKey& other) const {
+                return vertex_index == other.vertex_index &&
+                       normal_index == other.normal_index &&
+                       texcoord_index == other.texcoord_index &&
+                       material_id == other.material_id;
+            }
+        };
+        struct CornerKeyHash {
+            size_t operator()(const CornerKey& key) const {
+                size_t hash = std::hash<int>{}(key.vertex_index);
+                hash ^= std::hash<int>{}(key.normal_index) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                hash ^= std::hash<int>{}(key.texcoord_index) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                hash ^= std::hash<int>{}(key.material_id) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                return hash;
+            }
+        };
+
+        size_t num_corners = 0;
+        for (const auto& shape: shapes) {
+            num_corners += shape.mesh.indices.size();
+        }
+        std::unordered_map<CornerKey, uint32_t, CornerKeyHash> unique_corners;
+        unique_corners.reserve(num_corners / 2);
+        indices.reserve(num_corners);
+
+        for (const auto& shape: shapes) {
+            for (size_t i = 0; i < shape.mesh.indices.size(); i++) {
+                const auto& index       = shape.mesh.indices[i];
+                const int   face        = static_cast<int>(i / 3);
+                const int   material_id = material && face < static_cast<int>(shape.mesh.material_ids.size()) ? shape.mesh.material_ids[face] : -1;
+
+                const CornerKey key{index.vertex_index, index.normal_index, index.texcoord_index, material_id};
+                const auto      it = unique_corners.find(key);
+                if (it != unique_corners.end()) {
+                    indices.push_back(it->second);
+                    continue;
+                }
+
+                Vertex vertex(glm::vec3(attrib.vertices[3 * index.vertex_index + 0],
+                                        attrib.vertices[3 * index.vertex_index + 1],
+                                        attrib.vertices[3 * index.vertex_index + 2]));
+                if (index.normal_index >= 0) {
+                    vertex.normal = {attrib.normals[3 * index.normal_index + 0],
+                                     attrib.normals[3 * index.normal_index + 1],
+                                     attrib.normals[3 * index.normal_index + 2],
+                                     0.0f};
+                }
+                if (index.texcoord_index >= 0) {
+                    vertex.tex_coord = {attrib.texcoords[2 * index.texcoord_index + 0],
+                                        1.0f - attrib.texcoords[2 * index.texcoord_index + 1]}; // Flip Y-axis
+                }
+                if (material) {
+                    if (material_id >= 0 && material_id < static_cast<int>(materials.size())) {
+                        const auto& m = materials[material_id];
+                        vertex.color  = glm::vec4(m.diffuse[0], m.diffuse[1], m.diffuse[2], 1.0f);
+                    }
+                } else if (3 * index.vertex_index + 2 < static_cast<int>(attrib.colors.size())) {
+                    vertex.color = glm::vec4(attrib.colors[3 * index.vertex_index + 0],
+                                             attrib.colors[3 * index.vertex_index + 1],
+                                             attrib.colors[3 * index.vertex_index + 2],
+                                             1.0f);
+                }
+
+                const auto vertex_id = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(vertex);
+                unique_corners.emplace(key, vertex_id);
+                indices.push_back(vertex_id);
+            }
+        }
+        console("loaded OBJ: ", num_corners, " face corners welded to ", vertices.size(), " vertices");
+        return true;
+    }
+
     Sampler* loadSample(const std::string& filename) {
         unsigned int channels;
         unsigned int sample_rate;
@@ -306,6 +306,13 @@ namespace umfeld {
         g->vertex(x, y, z, u, v);
     }
 
+    void polygons(const std::vector<std::vector<glm::vec3>>& outlines, const bool close_shape) {
+        if (g == nullptr) {
+            return;
+        }
+        g->polygons(outlines, close_shape);
+    }
+
     PFont* loadFont(const std::string& file, const float size) {
         if (g == nullptr) {
             error("`loadFont` is only available after `settings()` has finished");
@@ -520,6 +527,41 @@ namespace umfeld {
         g->mesh(mesh_shape);
     }
 
+    void beginInstances() {
+        if (g == nullptr) {
+            return;
+        }
+        g->beginInstances();
+    }
+
+    void instance() {
+        if (g == nullptr) {
+            return;
+        }
+        g->instance();
+    }
+
+    void instance(const glm::mat4& transform, const glm::vec4& color) {
+        if (g == nullptr) {
+            return;
+        }
+        g->instance(transform, color);
+    }
+
+    void endInstances(VertexBuffer* mesh_shape) {
+        if (g == nullptr) {
+            return;
+        }
+        g->endInstances(mesh_shape);
+    }
+
+    void endInstances(const int instance_shape) {
+        if (g == nullptr) {
+            return;
+        }
+        g->endInstances(instance_shape);
+    }
+
     void shader(PShader* shader) {
         if (g == nullptr) {
             return;
@@ -0,0 +1,107 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * measures the block processing cost of audio classes in nanoseconds per sample for block sizes
+ * from 64 to 2048 frames.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "audio/ADSR.h"
+#include "audio/AudioUtilities.h"
+#include "audio/Filter.h"
+#include "audio/Sampler.h"
+#include "audio/Wavetable.h"
+
+using namespace umfeld;
+
+static constexpr float    SAMPLE_RATE       = 48000.0f;
+static constexpr uint32_t SAMPLES_PER_BLOCK = 1 << 22; // NOTE samples processed per measurement
+static constexpr int      NUM_RUNS          = 5;
+
+static double measure_ns_per_sample(const uint32_t block_size, const std::function<void(uint32_t)>& process_block) {
+    const uint32_t num_blocks = SAMPLES_PER_BLOCK / block_size;
+    double         best       = 0.0;
+    for (int run = 0; run < NUM_RUNS; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < num_blocks; ++i) {
+            process_block(block_size);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double                                   ns      = elapsed.count() / (static_cast<double>(num_blocks) * block_size);
+        best                                                   = run == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+int main() {
+    constexpr uint32_t BLOCK_SIZES[]  = {64, 128, 256, 512, 1024, 2048};
+    constexpr uint32_t MAX_BLOCK_SIZE = 2048;
+
+    std::vector<float> buffer(MAX_BLOCK_SIZE);
+    std::vector<float> left(MAX_BLOCK_SIZE);
+    std::vector<float> right(MAX_BLOCK_SIZE);
+    std::vector<float> interleaved(MAX_BLOCK_SIZE * 2);
+    std::vector<float> sample(static_cast<size_t>(SAMPLE_RATE));
+    Wavetable::fill(sample.data(), static_cast<uint32_t>(sample.size()), WAVEFORM_SINE);
+
+    Wavetable wavetable_power_of_two(512, SAMPLE_RATE);
+    Wavetable wavetable(500, SAMPLE_RATE);
+    wavetable_power_of_two.set_frequency(440.0f);
+    wavetable.set_frequency(440.0f);
+    ADSR envelope(SAMPLE_RATE);
+    envelope.set_sustain(1.0f);
+    envelope.start();
+    Filter filter(SAMPLE_RATE);
+    Sampler sampler(sample.data(), static_cast<int32_t>(sample.size()), SAMPLE_RATE);
+    sampler.enable_loop(true);
+    sampler.play();
+
+    struct Benchmark {
+        const char*                   name;
+        std::function<void(uint32_t)> process_block;
+    };
+    const Benchmark benchmarks[] = {
+        {"Wavetable (512)", [&](const uint32_t n) { wavetable_power_of_two.process(buffer.data(), n); }},
+        {"Wavetable (500)", [&](const uint32_t n) { wavetable.process(buffer.data(), n); }},
+        {"ADSR", [&](const uint32_t n) { envelope.process(buffer.data(), n); }},
+        {"Filter", [&](const uint32_t n) { filter.process(buffer.data(), n); }},
+        {"Sampler", [&](const uint32_t n) { sampler.process(buffer.data(), n); }},
+        {"interleave_stereo", [&](const uint32_t n) { AudioUtilities::interleave_stereo(left.data(), right.data(), interleaved.data(), n); }},
+        {"deinterleave_stereo", [&](const uint32_t n) { AudioUtilities::deinterleave_stereo(interleaved.data(), left.data(), right.data(), n); }},
+    };
+
+    std::printf("%-20s", "ns/sample");
+    for (const uint32_t block_size: BLOCK_SIZES) {
+        std::printf("%9u", block_size);
+    }
+    std::printf("\n");
+    for (const auto& benchmark: benchmarks) {
+        std::printf("%-20s", benchmark.name);
+        for (const uint32_t block_size: BLOCK_SIZES) {
+            std::printf("%9.3f", measure_ns_per_sample(block_size, benchmark.process_block));
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
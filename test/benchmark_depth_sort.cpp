@@ -0,0 +1,90 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * compares sorting translucent triangles back-to-front with `std::sort` on float depths against
+ * `radix_sort` on quantized depth keys ( as used by `PGraphics` ).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "libtess2/tesselator.h"
+#include "Vertex.h"
+#include "Geometry.h"
+
+using namespace umfeld;
+
+static constexpr int      DEPTH_KEY_BITS = 24;
+static constexpr uint32_t DEPTH_KEY_MAX  = (1u << DEPTH_KEY_BITS) - 1;
+static constexpr int      NUM_RUNS       = 10;
+
+template<typename F>
+static double measure_ms(F&& f) {
+    double best = 0.0;
+    for (int run = 0; run < NUM_RUNS; ++run) {
+        const auto                                      start   = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best                                                    = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main() {
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> distribution(1.0f, 1000.0f);
+    std::printf("%12s %14s %14s %10s\n", "triangles", "std::sort (ms)", "radix (ms)", "speedup");
+    for (const size_t num_triangles: {size_t(10000), size_t(100000), size_t(1000000)}) {
+        std::vector<float> depths(num_triangles);
+        for (auto& d: depths) {
+            d = distribution(rng);
+        }
+
+        std::vector<uint32_t> indices(num_triangles);
+        const double          sort_ms = measure_ms([&] {
+            for (uint32_t i = 0; i < num_triangles; ++i) {
+                indices[i] = i;
+            }
+            std::sort(indices.begin(), indices.end(), [&](const uint32_t a, const uint32_t b) {
+                return depths[a] > depths[b];
+            });
+        });
+
+        std::vector<uint32_t> keys(num_triangles);
+        std::vector<uint32_t> scratch_keys;
+        std::vector<uint32_t> scratch_indices;
+        const double          radix_ms = measure_ms([&] {
+            const auto [min_it, max_it] = std::minmax_element(depths.begin(), depths.end());
+            const float min_depth       = *min_it;
+            const float depth_scale     = *max_it > min_depth ? static_cast<float>(DEPTH_KEY_MAX) / (*max_it - min_depth) : 0.0f;
+            for (uint32_t i = 0; i < num_triangles; ++i) {
+                keys[i]    = DEPTH_KEY_MAX - std::min<uint32_t>(static_cast<uint32_t>((depths[i] - min_depth) * depth_scale), DEPTH_KEY_MAX);
+                indices[i] = i;
+            }
+            radix_sort(keys, indices, scratch_keys, scratch_indices, DEPTH_KEY_BITS);
+        });
+
+        std::printf("%12zu %14.3f %14.3f %9.2fx\n", num_triangles, sort_ms, radix_ms, sort_ms / radix_ms);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * Umfeld
+ *
+ * This file is part of the *Umfeld* library (https://github.com/dennisppaul/umfeld).
+ * Copyright (c) 2025 Dennis P Paul.
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * compares `StrokeTessellator` with `triangulate_line_strip` ( the path previously taken by
+ * `triangulate_line_strip_vertex` for all join modes ) for BEVEL, MITER and ROUND joins.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "libtess2/tesselator.h"
+#include "Vertex.h"
+#include "Geometry.h"
+#include "StrokeTessellator.h"
+
+using namespace umfeld;
+
+static constexpr size_t NUM_STRIPS           = 1000;
+static constexpr size_t NUM_POINTS_PER_STRIP = 64;
+static constexpr float  STROKE_WEIGHT        = 4.0f;
+static constexpr float  ROUND_RESOLUTION     = 0.34906585f; // NOTE 20° as in `PGraphics`
+static constexpr float  MITER_MAX_ANGLE      = 163.0f;
+static constexpr int    NUM_RUNS             = 5;
+
+template<typename F>
+static double measure_ms(F&& f) {
+    double best = 0.0;
+    for (int run = 0; run < NUM_RUNS; ++run) {
+        const auto                                      start   = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best                                                    = run == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main() {
+    /* random walks with moderate turns, similar to strokes drawn with `beginShape(LINE_STRIP)` */
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> turn(-1.2f, 1.2f);
+    std::uniform_real_distribution<float> length(10.0f, 30.0f);
+    std::vector<std::vector<glm::vec2>>   strips(NUM_STRIPS);
+    for (auto& strip: strips) {
+        glm::vec2 point{0.0f, 0.0f};
+        float     angle = 0.0f;
+        strip.reserve(NUM_POINTS_PER_STRIP);
+        for (size_t i = 0; i < NUM_POINTS_PER_STRIP; ++i) {
+            strip.push_back(point);
+            angle += turn(rng);
+            point += glm::vec2(std::cos(angle), std::sin(angle)) * length(rng);
+        }
+    }
+
+    struct JoinMode {
+        const char* name;
+        int         mode;
+    };
+    constexpr JoinMode join_modes[] = {{"BEVEL", BEVEL}, {"MITER", MITER}, {"ROUND", ROUND}};
+
+    std::vector<glm::vec2> triangles;
+    StrokeTessellator      stroke_tessellator;
+    std::printf("%-8s %22s %22s %10s %10s\n", "join", "triangulate_line_strip", "StrokeTessellator", "speedup", "fallbacks");
+    for (const auto& join_mode: join_modes) {
+        const double legacy_ms = measure_ms([&] {
+            for (const auto& strip: strips) {
+                triangles.clear();
+                triangulate_line_strip(strip, false, STROKE_WEIGHT, join_mode.mode, SQUARE,
+                                       ROUND_RESOLUTION, ROUND_RESOLUTION, MITER_MAX_ANGLE, triangles);
+            }
+        });
+
+        size_t       num_fallbacks  = 0;
+        const double tessellator_ms = measure_ms([&] {
+            num_fallbacks = 0;
+            stroke_tessellator.set_style(STROKE_WEIGHT, join_mode.mode, SQUARE, ROUND_RESOLUTION, ROUND_RESOLUTION, MITER_MAX_ANGLE);
+            for (const auto& strip: strips) {
+                triangles.clear();
+                if (!stroke_tessellator.tessellate(strip, false, triangles)) {
+                    num_fallbacks++;
+                }
+            }
+        });
+
+        std::printf("%-8s %19.3f ms %19.3f ms %9.2fx %10zu\n",
+                    join_mode.name, legacy_ms, tessellator_ms, legacy_ms / tessellator_ms, num_fallbacks);
+    }
+    return 0;
+}